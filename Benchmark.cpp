@@ -0,0 +1,335 @@
+// ============================================================================
+// File: Benchmark.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Timing benchmark for the greedy path construction.  Generates uniformly
+//   random points on a 300 x 300 x 2 mm block (fixed seed) and compares:
+//     • the original scan that removes visited points with vector::erase
+//     • the brute-force scan with a swap-remove unvisited array
+//     • the same scan split across all hardware threads
+//     • the k-d tree engine
+//   and checks that all four return the same order, also with coordinates
+//   near 1e200 whose squared distances overflow.  The Hilbert and Morton
+//   curve constructions are timed against them, and each construction is
+//   used as the seed of a 2-opt run to compare the final lengths; 2-opt
+//   also runs on the closed tour, which must still visit every point once.
+//   It then times the squared-distance argmin kernels (scalar and every
+//   SIMD level the CPU supports) over the same points and checks they pick
+//   the same candidates.
+//   Finally the points are written to a scratch CSV file, which is read back
+//   with readPoints() from ../common and with the memory-mapped loadPoints(),
+//   on one thread and on all of them, to compare their throughput; a binary
+//   copy of the file is loaded too (MB/s counted against the CSV size), with
+//   and without a tool column.
+//   Last, the points are written back with an iostream loop, with the
+//   buffered round-trip CSV writer of writeReorderedPoints() (checking that
+//   its output reads back bit-identical) and as order-only files.
+//
+// Usage:
+//   ./Benchmark [n ...]          (default: 50000)
+//
+// Build:
+//   make bench
+// ============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <numeric>   // for std::iota
+#include <limits>
+#include <thread>
+#include <algorithm>
+#include <cstdio>    // for std::remove
+#include <fstream>
+
+#include "Points.h"  // from ../common
+#include "PathOptimizer.h"
+#include "SpaceFillingCurve.h"
+#include "LocalSearch.h"
+#include "DistanceKernels.h"
+#include "PathIO.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Original implementation (pre swap-remove), kept here as the reference
+//------------------------------------------------------------------------------
+static vector<int> optimizePathErase(const vector<Point>& pts) {
+    size_t n = pts.size();
+    vector<int> remaining(n);
+    iota(remaining.begin(), remaining.end(), 0);
+
+    vector<int> order;
+    order.reserve(n);
+
+    int current = 0;
+    order.push_back(current);
+    remaining.erase(remaining.begin());
+
+    while (!remaining.empty()) {
+        double bestDist = numeric_limits<double>::max();
+        size_t bestIdx = 0;
+        for (size_t i = 0; i < remaining.size(); ++i) {
+            double dx = pts[remaining[i]].coords[0] - pts[current].coords[0];
+            double dy = pts[remaining[i]].coords[1] - pts[current].coords[1];
+            double dz = pts[remaining[i]].coords[2] - pts[current].coords[2];
+            double d = sqrt(dx * dx + dy * dy + dz * dz);
+            if (d < bestDist) {
+                bestDist = d;
+                bestIdx = i;
+            }
+        }
+        current = remaining[bestIdx];
+        order.push_back(current);
+        remaining.erase(remaining.begin() + bestIdx);
+    }
+
+    return order;
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+static vector<Point> randomPoints(size_t n, unsigned seed) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> xy(0.0, 300.0), z(0.0, 2.0);
+    vector<Point> pts(n);
+    for (size_t i = 0; i < n; ++i) {
+        pts[i].label = "P" + to_string(i);
+        pts[i].coords = {xy(rng), xy(rng), z(rng)};
+    }
+    return pts;
+}
+
+template <class F>
+static double timeIt(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static void report(const string& name, double seconds, double length, bool same,
+                   const char* problem = "ORDER DIFFERS") {
+    cout << "  " << left << setw(26) << name << right
+         << setw(10) << fixed << setprecision(3) << seconds << " s"
+         << "   length = " << setprecision(2) << length
+         << (same ? "" : "   ") << (same ? "" : problem) << endl;
+}
+
+// Does 'order' visit each of the n points once, starting at 'start'?
+static bool isPath(const vector<int>& order, size_t n, int start) {
+    if (order.size() != n || order.empty() || order[0] != start) return false;
+    vector<char> seen(n, 0);
+    for (int i : order) {
+        if (i < 0 || static_cast<size_t>(i) >= n || seen[i]) return false;
+        seen[i] = 1;
+    }
+    return true;
+}
+
+// Closest-point queries from the first 'queries' points against all points,
+// with lowest-index ties; returns the winning slots
+static vector<size_t> runKernel(ArgminKernel kernel, const PointSet& pts, const vector<int>& id,
+                                size_t queries) {
+    vector<size_t> winners;
+    winners.reserve(queries);
+    for (size_t q = 0; q < queries; ++q)
+        winners.push_back(kernel(pts.x.data(), pts.y.data(), pts.z.data(), id.data(), 0, pts.size(),
+                                 pts.x[q] + 0.5, pts.y[q] + 0.5, pts.z[q]).idx);
+    return winners;
+}
+
+static void reportRead(const string& name, double seconds, double megabytes, bool same) {
+    cout << "    " << left << setw(24) << name << right
+         << setw(10) << fixed << setprecision(3) << seconds << " s   "
+         << setprecision(0) << megabytes / seconds << " MB/s"
+         << (same ? "" : "   POINTS DIFFER") << endl;
+}
+
+static void reportWrite(const string& name, double seconds, bool same) {
+    cout << "    " << left << setw(24) << name << right
+         << setw(10) << fixed << setprecision(3) << seconds << " s"
+         << (same ? "" : "   OUTPUT DIFFERS") << endl;
+}
+
+static bool samePoints(const PointSet& a, const PointSet& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(stoul(argv[i]));
+    if (sizes.empty()) sizes.push_back(50000);
+
+    string parName = "brute force, " + to_string(max(1u, thread::hardware_concurrency())) + " threads";
+
+    for (size_t n : sizes) {
+        vector<Point> points = randomPoints(n, 12345);
+        PointSet pts(points);
+        cout << "n = " << n << endl;
+
+        vector<int> ref, swapRm, par, kd;
+        double tErase = timeIt([&] { ref = optimizePathErase(points); });
+        double tSwap  = timeIt([&] { swapRm = optimizePathBruteForce(pts); });
+        double tPar   = timeIt([&] { par = optimizePathBruteForce(pts, true, 0); });
+        double tKd    = timeIt([&] { kd = optimizePathKdTree(pts); });
+
+        report("brute force, erase",       tErase, computePathLength(pts, ref),    true);
+        report("brute force, swap-remove", tSwap,  computePathLength(pts, swapRm), swapRm == ref);
+        report(parName,                    tPar,   computePathLength(pts, par),    par == ref);
+        report("k-d tree",                 tKd,    computePathLength(pts, kd),     kd == ref);
+
+        // Coordinates near 1e200: every squared distance overflows to
+        // infinity, and each kernel and chunk must still take its first
+        // candidate, so the engines keep agreeing.  The k-d tree cannot
+        // prune on infinite distances, so at most 10000 points are used
+        // (lengths of the unscaled points).
+        vector<Point> hugePoints(points.begin(), points.begin() + min<size_t>(n, 10000));
+        PointSet hugeRef(hugePoints);
+        for (Point& p : hugePoints)
+            for (double& c : p.coords) c *= 1e200;
+        PointSet huge(hugePoints);
+        vector<int> hugeSwap, hugePar, hugeKd;
+        double tHugeSwap = timeIt([&] { hugeSwap = optimizePathBruteForce(huge); });
+        double tHugePar  = timeIt([&] { hugePar = optimizePathBruteForce(huge, true, 0); });
+        double tHugeKd   = timeIt([&] { hugeKd = optimizePathKdTree(huge); });
+        report("1e200 coords, swap-remove", tHugeSwap, computePathLength(hugeRef, hugeSwap), true);
+        report("1e200 coords, threads",     tHugePar,  computePathLength(hugeRef, hugePar),  hugePar == hugeSwap);
+        report("1e200 coords, k-d tree",    tHugeKd,   computePathLength(hugeRef, hugeKd),   hugeKd == hugeSwap);
+
+        // Space-filling curves: much faster, longer paths; as seeds of
+        // 2-opt they mostly catch up with the greedy walk
+        vector<int> hilbert, morton;
+        double tHilbert = timeIt([&] { hilbert = curvePath(pts, Curve::Hilbert); });
+        double tMorton  = timeIt([&] { morton = curvePath(pts, Curve::Morton); });
+        report("Hilbert curve", tHilbert, computePathLength(pts, hilbert), true);
+        report("Morton curve",  tMorton,  computePathLength(pts, morton),  true);
+
+        cout << "  2-opt from each construction:" << endl;
+        NeighborLists nbr = buildNeighborLists(pts, 10);
+        for (auto* seed : {&kd, &hilbert, &morton}) {
+            vector<int> order = *seed;
+            double t = timeIt([&] { twoOpt(pts, order, nbr); });
+            report(seed == &kd ? "  k-d tree + 2-opt" : seed == &hilbert ? "  Hilbert + 2-opt" : "  Morton + 2-opt",
+                   t, computePathLength(pts, order), true);
+        }
+
+        // Closed tour: the return move is charged on the depot edges, so
+        // 2-opt moves them like any other (make bench SANITIZE=address runs
+        // this under AddressSanitizer)
+        PathEnds closedEnds;
+        closedEnds.start = kd[0];
+        closedEnds.closed = true;
+        vector<int> closedOrder = kd;
+        double tClosed = timeIt([&] { twoOpt(pts, closedOrder, nbr, closedEnds); });
+        report("  closed tour + 2-opt", tClosed, computePathLength(pts, closedOrder, Euclidean3D(), true),
+               isPath(closedOrder, n, kd[0]), "NOT A TOUR");
+
+        vector<int> id(n);
+        iota(id.begin(), id.end(), 0);
+        size_t queries = min<size_t>(n, 2000);
+        vector<size_t> scalarWinners;
+        double tScalar = 0.0;
+        cout << "  argmin kernels, " << queries << " queries:" << endl;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detectSimdLevel()) break;
+            vector<size_t> winners;
+            double t = timeIt([&] { winners = runKernel(argminKernel(level), pts, id, queries); });
+            if (level == SimdLevel::Scalar) {
+                scalarWinners = winners;
+                tScalar = t;
+            }
+            cout << "    " << left << setw(24) << simdLevelName(level) << right
+                 << setw(10) << fixed << setprecision(3) << t << " s   speed-up = "
+                 << setprecision(2) << tScalar / t
+                 << (winners == scalarWinners ? "" : "   RESULT DIFFERS") << endl;
+        }
+
+        const string scratch = "Benchmark_points.csv";
+        vector<int> identity(n);
+        iota(identity.begin(), identity.end(), 0);
+        if (!writeReorderedPoints(scratch, points, identity)) {
+            cerr << "Error: cannot write " << scratch << endl;
+            return 1;
+        }
+        MappedFile file;
+        file.open(scratch);
+        double megabytes = file.size() / 1e6;
+        cout << "  reading " << setprecision(1) << megabytes << " MB of CSV:" << endl;
+
+        PointSet common;
+        PointCloud cloud;
+        string error;
+        double tCommon = timeIt([&] { common = PointSet(readPoints(scratch, 3)); });
+        double tMapped = timeIt([&] { loadPoints(scratch, cloud, error); });
+        reportRead("readPoints()", tCommon, megabytes, true);
+        reportRead("loadPoints() (mmap)", tMapped, megabytes, samePoints(cloud.coords, common));
+
+        PointCloud parallel;
+        LoadStats ls;
+        double tParallel = timeIt([&] { loadPoints(scratch, parallel, error, 0, &ls); });
+        reportRead("loadPoints(), " + to_string(ls.threads) + " threads", tParallel, megabytes,
+                   samePoints(parallel.coords, common) && parallel.labels == cloud.labels);
+
+        const string scratchBinary = "Benchmark_points.bin";
+        if (!writeReorderedPoints(scratchBinary, cloud, identity, PointFormat::Binary)) {
+            cerr << "Error: cannot write " << scratchBinary << endl;
+            return 1;
+        }
+        PointCloud binary;
+        double tBinary = timeIt([&] { loadPoints(scratchBinary, binary, error); });
+        reportRead("loadPoints(), binary", tBinary, megabytes,
+                   samePoints(binary.coords, common) && binary.labels == cloud.labels);
+
+        // The tool column must survive the binary format as well
+        static const string_view toolNames[] = {"T1", "T2", "T3"};
+        cloud.tools.resize(n);
+        for (size_t i = 0; i < n; ++i) cloud.tools[i] = toolNames[i % 3];
+        writeReorderedPoints(scratchBinary, cloud, identity, PointFormat::Binary);
+        PointCloud binaryTools;
+        double tBinaryTools = timeIt([&] { loadPoints(scratchBinary, binaryTools, error); });
+        reportRead("loadPoints(), bin+tools", tBinaryTools, megabytes,
+                   samePoints(binaryTools.coords, common) && binaryTools.labels == cloud.labels &&
+                   binaryTools.tools == cloud.tools);
+        cloud.tools.clear();
+
+        // Writing: the iostream loop writeReorderedPoints() used to run
+        // (6 significant digits), against the buffered round-trip writer,
+        // whose output must read back to the same points, and the
+        // order-only formats
+        const string scratchOut = "Benchmark_out.csv", scratchStream = "Benchmark_stream.csv";
+        cout << "  writing " << n << " points:" << endl;
+        double tStream = timeIt([&] {
+            ofstream out(scratchStream);
+            for (int idx : identity) {
+                out << cloud.labels[idx] << "," << cloud.coords.x[idx] << ","
+                    << cloud.coords.y[idx] << "," << cloud.coords.z[idx] << "\n";
+            }
+        });
+        double tFast = timeIt([&] { writeReorderedPoints(scratchOut, cloud, identity); });
+        double tOrderText = timeIt([&] { writeReorderedPoints(scratchBinary, cloud, identity, PointFormat::OrderText); });
+        double tOrderBinary = timeIt([&] { writeReorderedPoints(scratchBinary, cloud, identity, PointFormat::OrderBinary); });
+        PointCloud reread;
+        loadPoints(scratchOut, reread, error);
+        bool roundTrip = samePoints(reread.coords, cloud.coords) && reread.labels == cloud.labels;
+        reportWrite("ostream CSV, 6 digits", tStream, true);
+        reportWrite("to_chars CSV, round trip", tFast, roundTrip);
+        reportWrite("order, text", tOrderText, true);
+        reportWrite("order, uint32", tOrderBinary, true);
+
+        remove(scratch.c_str());
+        remove(scratchBinary.c_str());
+        remove(scratchOut.c_str());
+        remove(scratchStream.c_str());
+    }
+    return 0;
+}
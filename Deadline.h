@@ -0,0 +1,66 @@
+// ============================================================================
+// File: Deadline.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Wall-clock budget for the anytime optimization mode (--time-limit).
+//
+//   expired() is meant for inner loops: it only reads the monotonic clock
+//   once every 16 calls and remembers a hit, so an unlimited deadline costs a
+//   single branch and a limited one a counter increment.  Loops whose
+//   iterations are expensive should call expiredNow() instead.
+// ============================================================================
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <chrono>
+
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // No limit: never expires
+    Deadline() = default;
+
+    // Expires 'seconds' after 'start'
+    explicit Deadline(double seconds, Clock::time_point start = Clock::now())
+        : limited(true),
+          end(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds))) {}
+
+    bool isLimited() const { return limited; }
+
+    // A deadline 'fraction' of the way from now to this one, to give one
+    // step of a longer computation its part of the budget (unlimited if
+    // this one is)
+    Deadline share(double fraction) const {
+        if (!limited) return Deadline();
+        Clock::time_point now = Clock::now();
+        return Deadline(fraction * std::chrono::duration<double>(end - now).count(), now);
+    }
+
+    bool expired() const {
+        if (!limited) return false;
+        if (hit) return true;
+        if ((++calls & kStride) != 0) return false;
+        hit = Clock::now() >= end;
+        return hit;
+    }
+
+    bool expiredNow() const {
+        if (!limited) return false;
+        if (!hit) hit = Clock::now() >= end;
+        return hit;
+    }
+
+private:
+    static constexpr unsigned kStride = 15;   // clock read every 16 calls
+
+    bool limited = false;
+    Clock::time_point end{};
+    mutable unsigned calls = 0;
+    mutable bool hit = false;
+};
+
+#endif
@@ -0,0 +1,217 @@
+// ============================================================================
+// File: DistanceKernels.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Scalar and x86 SIMD squared-distance argmin kernels with run-time
+//   dispatch (see DistanceKernels.h).  The SIMD versions are compiled with
+//   per-function target attributes, so the rest of the program keeps the
+//   baseline instruction set.
+// ============================================================================
+
+#include "DistanceKernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DISTANCEKERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Scalar reference
+//------------------------------------------------------------------------------
+template <bool Keyed>
+ArgminResult argminScalar(const double* x, const double* y, const double* z, const int* key,
+                          size_t begin, size_t end, double cx, double cy, double cz) {
+    ArgminResult best;
+    best.idx = begin;
+    for (size_t i = begin; i < end; ++i) {
+        double dx = x[i] - cx;
+        double dy = y[i] - cy;
+        double dz = z[i] - cz;
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if (i == begin || d2 < best.dist2 || (Keyed && d2 == best.dist2 && key[i] < key[best.idx])) {
+            best.dist2 = d2;
+            best.idx = i;
+        }
+    }
+    return best;
+}
+
+#ifdef DISTANCEKERNELS_X86
+
+// Every lane keeps its own (dist2, key, slot) best; the lanes are then merged
+// lexicographically on (dist2, key) and the tail is finished in scalar code.
+// Without a key array the slot itself is the key.  The lanes start from an
+// infinite distance at their first slot, so a lane whose squared distances
+// all overflow still takes its first candidate and always names a slot of
+// the range, as the scalar kernel does.
+template <int Lanes, bool Keyed>
+ArgminResult mergeLanes(const double* d, const double* k, const double* s,
+                        const double* x, const double* y, const double* z, const int* key,
+                        size_t i, size_t end, double cx, double cy, double cz) {
+    ArgminResult best;
+    double bestKey = numeric_limits<double>::infinity();
+    bool found = false;
+    for (int l = 0; l < Lanes; ++l) {
+        if (!found || d[l] < best.dist2 || (d[l] == best.dist2 && k[l] < bestKey)) {
+            best.dist2 = d[l];
+            bestKey = k[l];
+            best.idx = static_cast<size_t>(s[l]);
+            found = true;
+        }
+    }
+    if (i < end) {
+        ArgminResult tail = argminScalar<Keyed>(x, y, z, key, i, end, cx, cy, cz);
+        double tailKey = Keyed ? key[tail.idx] : static_cast<double>(tail.idx);
+        if (!found || tail.dist2 < best.dist2 || (tail.dist2 == best.dist2 && tailKey < bestKey))
+            best = tail;
+    }
+    return best;
+}
+
+//------------------------------------------------------------------------------
+// AVX2: 4 candidates per instruction.  Most blocks hold nothing closer than
+// the lanes' current best, so those are skipped on a well-predicted branch
+// instead of going through the blend chain.
+//------------------------------------------------------------------------------
+template <bool Keyed>
+__attribute__((target("avx2")))
+ArgminResult argminAvx2(const double* x, const double* y, const double* z, const int* key,
+                        size_t begin, size_t end, double cx, double cy, double cz) {
+    const __m256d qx = _mm256_set1_pd(cx), qy = _mm256_set1_pd(cy), qz = _mm256_set1_pd(cz);
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d bestD = _mm256_set1_pd(numeric_limits<double>::infinity());
+    __m256d bestK = bestD;
+    __m256d slot = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(begin)),
+                                 _mm256_setr_pd(0.0, 1.0, 2.0, 3.0));
+    __m256d bestS = slot;
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), qx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), qy);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i), qz);
+        __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                   _mm256_mul_pd(dz, dz));
+        __m256d close = _mm256_cmp_pd(d2, bestD, _CMP_LE_OQ);
+        if (_mm256_movemask_pd(close) == 0) {
+            slot = _mm256_add_pd(slot, step);
+            continue;
+        }
+        __m256d k = Keyed ? _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key + i)))
+                          : slot;
+        __m256d take = _mm256_or_pd(_mm256_cmp_pd(d2, bestD, _CMP_LT_OQ),
+                                    _mm256_and_pd(_mm256_cmp_pd(d2, bestD, _CMP_EQ_OQ),
+                                                  _mm256_cmp_pd(k, bestK, _CMP_LT_OQ)));
+        bestD = _mm256_blendv_pd(bestD, d2, take);
+        bestK = _mm256_blendv_pd(bestK, k, take);
+        bestS = _mm256_blendv_pd(bestS, slot, take);
+        slot = _mm256_add_pd(slot, step);
+    }
+
+    alignas(32) double d[4], k[4], s[4];
+    _mm256_store_pd(d, bestD);
+    _mm256_store_pd(k, bestK);
+    _mm256_store_pd(s, bestS);
+    if (i == begin) return argminScalar<Keyed>(x, y, z, key, begin, end, cx, cy, cz);
+    return mergeLanes<4, Keyed>(d, k, s, x, y, z, key, i, end, cx, cy, cz);
+}
+
+//------------------------------------------------------------------------------
+// AVX-512: 8 candidates per instruction
+//------------------------------------------------------------------------------
+template <bool Keyed>
+__attribute__((target("avx512f")))
+ArgminResult argminAvx512(const double* x, const double* y, const double* z, const int* key,
+                          size_t begin, size_t end, double cx, double cy, double cz) {
+    const __m512d qx = _mm512_set1_pd(cx), qy = _mm512_set1_pd(cy), qz = _mm512_set1_pd(cz);
+    const __m512d step = _mm512_set1_pd(8.0);
+    __m512d bestD = _mm512_set1_pd(numeric_limits<double>::infinity());
+    __m512d bestK = bestD;
+    __m512d slot = _mm512_add_pd(_mm512_set1_pd(static_cast<double>(begin)),
+                                 _mm512_setr_pd(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0));
+    __m512d bestS = slot;
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i), qx);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i), qy);
+        __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(z + i), qz);
+        __m512d d2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)),
+                                   _mm512_mul_pd(dz, dz));
+        if (_mm512_cmp_pd_mask(d2, bestD, _CMP_LE_OQ) == 0) {
+            slot = _mm512_add_pd(slot, step);
+            continue;
+        }
+        __m512d k = Keyed ? _mm512_maskz_cvtepi32_pd(0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + i)))
+                          : slot;
+        __mmask8 take = _mm512_cmp_pd_mask(d2, bestD, _CMP_LT_OQ) |
+                        (_mm512_cmp_pd_mask(d2, bestD, _CMP_EQ_OQ) & _mm512_cmp_pd_mask(k, bestK, _CMP_LT_OQ));
+        bestD = _mm512_mask_blend_pd(take, bestD, d2);
+        bestK = _mm512_mask_blend_pd(take, bestK, k);
+        bestS = _mm512_mask_blend_pd(take, bestS, slot);
+        slot = _mm512_add_pd(slot, step);
+    }
+
+    alignas(64) double d[8], k[8], s[8];
+    _mm512_store_pd(d, bestD);
+    _mm512_store_pd(k, bestK);
+    _mm512_store_pd(s, bestS);
+    if (i == begin) return argminScalar<Keyed>(x, y, z, key, begin, end, cx, cy, cz);
+    return mergeLanes<8, Keyed>(d, k, s, x, y, z, key, i, end, cx, cy, cz);
+}
+
+#endif // DISTANCEKERNELS_X86
+
+// Keyed or not is decided per call, so each level has a small trampoline
+template <ArgminResult (*Keyed)(const double*, const double*, const double*, const int*,
+                                size_t, size_t, double, double, double),
+          ArgminResult (*Plain)(const double*, const double*, const double*, const int*,
+                                size_t, size_t, double, double, double)>
+ArgminResult dispatchKey(const double* x, const double* y, const double* z, const int* key,
+                         size_t begin, size_t end, double cx, double cy, double cz) {
+    return key ? Keyed(x, y, z, key, begin, end, cx, cy, cz)
+               : Plain(x, y, z, key, begin, end, cx, cy, cz);
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// Dispatch
+//------------------------------------------------------------------------------
+SimdLevel detectSimdLevel() {
+#ifdef DISTANCEKERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2:   return "AVX2";
+        default:                return "scalar";
+    }
+}
+
+ArgminKernel argminKernel(SimdLevel level) {
+#ifdef DISTANCEKERNELS_X86
+    if (level == SimdLevel::AVX512) return dispatchKey<argminAvx512<true>, argminAvx512<false>>;
+    if (level == SimdLevel::AVX2)   return dispatchKey<argminAvx2<true>, argminAvx2<false>>;
+#else
+    (void)level;
+#endif
+    return dispatchKey<argminScalar<true>, argminScalar<false>>;
+}
+
+ArgminKernel argminKernel() {
+    static const ArgminKernel kernel = argminKernel(detectSimdLevel());
+    return kernel;
+}
@@ -0,0 +1,51 @@
+// ============================================================================
+// File: DistanceKernels.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Vectorized "closest candidate" kernels for the brute-force greedy scan.
+//   A kernel takes packed x[], y[], z[] arrays and returns the slot in
+//   [begin, end) with the smallest squared distance to (cx, cy, cz).
+//
+//   Scalar, AVX2 (4 doubles per instruction) and AVX-512 (8 doubles) versions
+//   are compiled into the same binary; the best one the CPU supports is
+//   picked at run time, so one executable runs on old and new machines.  The
+//   vector kernels evaluate dx*dx + dy*dy + dz*dz in the same order as the
+//   scalar one, without FMA, and resolve ties the same way, so every kernel
+//   returns the same slot.
+//
+//   Ties on the squared distance go to the lowest key[i] when a key array is
+//   given (keys must be distinct, as point indices are), otherwise to the
+//   lowest slot.
+// ============================================================================
+
+#ifndef DISTANCEKERNELS_H
+#define DISTANCEKERNELS_H
+
+#include <cstddef>
+#include <limits>
+
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+struct ArgminResult {
+    double dist2 = std::numeric_limits<double>::infinity();   // squared distances may overflow
+    std::size_t idx = 0;
+};
+
+using ArgminKernel = ArgminResult (*)(const double* x, const double* y, const double* z,
+                                      const int* key, std::size_t begin, std::size_t end,
+                                      double cx, double cy, double cz);
+
+// Widest level supported by both this build and the running CPU
+SimdLevel detectSimdLevel();
+
+const char* simdLevelName(SimdLevel level);
+
+// Kernel for a given level (levels not compiled in fall back to scalar)
+ArgminKernel argminKernel(SimdLevel level);
+
+// Kernel for detectSimdLevel(), selected once per process
+ArgminKernel argminKernel();
+
+#endif
@@ -0,0 +1,239 @@
+// ============================================================================
+// File: KdTree.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Implementation of the k-d tree declared in KdTree.h.  Nodes keep a tight
+//   bounding box and a count of the points still present below them, so
+//   subtrees emptied by deletions are skipped at no cost.
+//
+//   Distances are compared exactly as in the brute-force scan (the metric
+//   key of candidate minus query, plus the candidate's point cost for the
+//   nearest query of metrics that have one), and a subtree is pruned only
+//   when its bounding box is strictly farther than the best candidate, so
+//   equal-distance ties can still be resolved by point index.
+// ============================================================================
+
+#include "KdTree.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Lower bound on the key of any point inside a node's box: the metric applied
+// to the per-axis gaps between q and the box
+//------------------------------------------------------------------------------
+template <class Metric>
+static inline double boxKey(const Metric& metric, const double lo[3], const double hi[3],
+                            const double q[3]) {
+    double g[3];
+    for (int k = 0; k < 3; ++k) {
+        g[k] = 0.0;
+        if (q[k] < lo[k])      g[k] = lo[k] - q[k];
+        else if (q[k] > hi[k]) g[k] = q[k] - hi[k];
+    }
+    return metric.key(g[0], g[1], g[2]);
+}
+
+//------------------------------------------------------------------------------
+// Construction
+//------------------------------------------------------------------------------
+template <class Metric>
+KdTree<Metric>::KdTree(const PointSet& pts, const Metric& metric_, int leafSize_)
+    : metric(metric_), leafSize(max(1, leafSize_)), nAlive(static_cast<int>(pts.size())) {
+    int n = nAlive;
+    index.resize(n);
+    for (int i = 0; i < n; ++i) index[i] = i;
+
+    xyz.resize(3 * size_t(n));
+    for (int i = 0; i < n; ++i) {
+        xyz[3 * size_t(i)]     = pts.x[i];
+        xyz[3 * size_t(i) + 1] = pts.y[i];
+        xyz[3 * size_t(i) + 2] = pts.z[i];
+    }
+
+    leafOf.assign(n, -1);
+    nodes.reserve(n > 0 ? 2 * (n / leafSize + 1) : 0);
+    if (n > 0) build(0, n, -1);
+
+    // Re-pack coordinates in slot order so that leaf scans are contiguous
+    vector<double> packed(3 * size_t(n));
+    slotOf.resize(n);
+    for (int s = 0; s < n; ++s) {
+        slotOf[index[s]] = s;
+        for (int k = 0; k < 3; ++k) packed[3 * size_t(s) + k] = xyz[3 * size_t(index[s]) + k];
+    }
+    xyz.swap(packed);
+    present.assign(n, 1);
+}
+
+template <class Metric>
+int KdTree<Metric>::build(int begin, int end, int parent) {
+    int id = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+    Node nd;
+    nd.begin = begin;
+    nd.end = end;
+    nd.left = nd.right = -1;
+    nd.parent = parent;
+    nd.alive = end - begin;
+    for (int k = 0; k < 3; ++k) {
+        nd.lo[k] = numeric_limits<double>::max();
+        nd.hi[k] = -numeric_limits<double>::max();
+    }
+    for (int s = begin; s < end; ++s)
+        for (int k = 0; k < 3; ++k) {
+            double c = xyz[3 * size_t(index[s]) + k];
+            nd.lo[k] = min(nd.lo[k], c);
+            nd.hi[k] = max(nd.hi[k], c);
+        }
+
+    if (end - begin > leafSize) {
+        // Split at the median of the widest axis the metric uses
+        int axis = 0;
+        for (int k = 1; k < (Metric::usesZ ? 3 : 2); ++k)
+            if (nd.hi[k] - nd.lo[k] > nd.hi[axis] - nd.lo[axis]) axis = k;
+        int mid = begin + (end - begin) / 2;
+        nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end,
+                    [&](int a, int b) {
+                        double ca = xyz[3 * size_t(a) + axis], cb = xyz[3 * size_t(b) + axis];
+                        return ca < cb || (ca == cb && a < b);
+                    });
+        nd.left = build(begin, mid, id);
+        nd.right = build(mid, end, id);
+    } else {
+        for (int s = begin; s < end; ++s) leafOf[s] = id;
+    }
+    nodes[id] = nd;
+    return id;
+}
+
+//------------------------------------------------------------------------------
+// Queries
+//------------------------------------------------------------------------------
+template <class Metric>
+int KdTree<Metric>::nearest(double x, double y, double z) const {
+    if (nAlive == 0) return -1;
+    const double q[3] = {x, y, z};
+    double bestKey = numeric_limits<double>::infinity();   // keys may overflow
+    int best = -1;
+    search(0, q, bestKey, best);
+    return best;
+}
+
+template <class Metric>
+void KdTree<Metric>::search(int ni, const double q[3], double& bestKey, int& best) const {
+    const Node& nd = nodes[ni];
+    if (nd.left < 0) {
+        for (int s = nd.begin; s < nd.end; ++s) {
+            if (!present[s]) continue;
+            double dx = xyz[3 * size_t(s)]     - q[0];
+            double dy = xyz[3 * size_t(s) + 1] - q[1];
+            double dz = xyz[3 * size_t(s) + 2] - q[2];
+            double key = metric.key(dx, dy, dz);
+            if constexpr (Metric::hasPointCost) key += metric.pointCost(xyz[3 * size_t(s) + 2]);
+            if (best < 0 || key < bestKey || (key == bestKey && index[s] < best)) {
+                bestKey = key;
+                best = index[s];
+            }
+        }
+        return;
+    }
+
+    // Visit the closer child first; prune children strictly beyond the best.
+    // The point cost is smallest at the top of a box.
+    int first = nd.left, second = nd.right;
+    double keyFirst  = boxKey(metric, nodes[first].lo,  nodes[first].hi,  q);
+    double keySecond = boxKey(metric, nodes[second].lo, nodes[second].hi, q);
+    if constexpr (Metric::hasPointCost) {
+        keyFirst  += metric.pointCost(nodes[first].hi[2]);
+        keySecond += metric.pointCost(nodes[second].hi[2]);
+    }
+    if (keySecond < keyFirst) {
+        swap(first, second);
+        swap(keyFirst, keySecond);
+    }
+    if (nodes[first].alive > 0 && keyFirst <= bestKey)   search(first, q, bestKey, best);
+    if (nodes[second].alive > 0 && keySecond <= bestKey) search(second, q, bestKey, best);
+}
+
+template <class Metric>
+void KdTree<Metric>::kNearest(int i, int k, vector<int>& out) const {
+    out.clear();
+    if (k <= 0 || nAlive == 0) return;
+    const double* c = &xyz[3 * size_t(slotOf[i])];
+    const double q[3] = {c[0], c[1], c[2]};
+
+    // Max-heap on (key, index): the front is the worst of the k kept
+    vector<pair<double, int>> heap;
+    heap.reserve(k + 1);
+    searchK(0, q, i, k, heap);
+
+    sort_heap(heap.begin(), heap.end());
+    for (const auto& e : heap) out.push_back(e.second);
+}
+
+template <class Metric>
+void KdTree<Metric>::searchK(int ni, const double q[3], int self, int k,
+                             vector<pair<double, int>>& heap) const {
+    const Node& nd = nodes[ni];
+    if (nd.left < 0) {
+        for (int s = nd.begin; s < nd.end; ++s) {
+            if (!present[s] || index[s] == self) continue;
+            double dx = xyz[3 * size_t(s)]     - q[0];
+            double dy = xyz[3 * size_t(s) + 1] - q[1];
+            double dz = xyz[3 * size_t(s) + 2] - q[2];
+            pair<double, int> cand(metric.key(dx, dy, dz), index[s]);
+            if (static_cast<int>(heap.size()) < k) {
+                heap.push_back(cand);
+                push_heap(heap.begin(), heap.end());
+            } else if (cand < heap.front()) {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = cand;
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+
+    int first = nd.left, second = nd.right;
+    double keyFirst  = boxKey(metric, nodes[first].lo,  nodes[first].hi,  q);
+    double keySecond = boxKey(metric, nodes[second].lo, nodes[second].hi, q);
+    if (keySecond < keyFirst) {
+        swap(first, second);
+        swap(keyFirst, keySecond);
+    }
+    auto worth = [&](int child, double bound) {
+        if (nodes[child].alive == 0) return false;
+        return static_cast<int>(heap.size()) < k || bound <= heap.front().first;
+    };
+    if (worth(first, keyFirst))   searchK(first, q, self, k, heap);
+    if (worth(second, keySecond)) searchK(second, q, self, k, heap);
+}
+
+//------------------------------------------------------------------------------
+// Deletion and re-insertion
+//------------------------------------------------------------------------------
+template <class Metric>
+void KdTree<Metric>::remove(int i) {
+    int s = slotOf[i];
+    if (!present[s]) return;
+    present[s] = 0;
+    --nAlive;
+    for (int ni = leafOf[s]; ni >= 0; ni = nodes[ni].parent) --nodes[ni].alive;
+}
+
+template <class Metric>
+void KdTree<Metric>::insert(int i) {
+    int s = slotOf[i];
+    if (present[s]) return;
+    present[s] = 1;
+    ++nAlive;
+    for (int ni = leafOf[s]; ni >= 0; ni = nodes[ni].parent) ++nodes[ni].alive;
+}
+
+#define INSTANTIATE(M) template class KdTree<M>;
+PATHOPT_FOR_EACH_METRIC(INSTANTIATE)
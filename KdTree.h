@@ -0,0 +1,77 @@
+// ============================================================================
+// File: KdTree.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Static k-d tree over the (X, Y, Z) coordinates of a point set, supporting
+//   "nearest remaining point" queries with deletion (and re-insertion).  It
+//   is the spatial index behind the greedy nearest-neighbor construction in
+//   OptimizePath.cpp and brings that construction from O(n^2) down to
+//   roughly O(n log n).
+//
+//   Queries compare the keys of the Metric policy (Metric.h; squared
+//   distances for the Euclidean metrics) and break ties towards the lowest
+//   point index, so a greedy walk driven by this tree visits points in
+//   exactly the same order as the brute-force scan.  The tree is
+//   instantiated for every policy in KdTree.cpp.
+// ============================================================================
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <utility>
+#include <vector>
+
+#include "PointSet.h"
+#include "Metric.h"
+
+template <class Metric = Euclidean3D>
+class KdTree {
+public:
+    // Build the tree over all points; every point starts out present.
+    explicit KdTree(const PointSet& pts, const Metric& metric = Metric(), int leafSize = 8);
+
+    // Index of the present point closest to (x, y, z), or -1 if none is left.
+    int nearest(double x, double y, double z) const;
+
+    // The (at most) k present points closest to point i, excluding i itself,
+    // sorted by increasing distance (ties by index).  Replaces the contents
+    // of out.
+    void kNearest(int i, int k, std::vector<int>& out) const;
+
+    // Remove point i from further queries (no-op if already removed).
+    void remove(int i);
+
+    // Put a removed point back (no-op if present).  Boxes are never shrunk,
+    // so a tree can also start empty and have points released into it.
+    void insert(int i);
+
+    int size() const { return nAlive; }
+
+private:
+    struct Node {
+        int begin, end;       // range of slots covered by this node
+        int left, right;      // children (-1 for leaves)
+        int parent;
+        int alive;            // present points below this node
+        double lo[3], hi[3];  // bounding box of the node's points
+    };
+
+    int build(int begin, int end, int parent);
+    void search(int node, const double q[3], double& bestKey, int& best) const;
+    void searchK(int node, const double q[3], int self, int k,
+                 std::vector<std::pair<double, int>>& heap) const;
+
+    Metric metric;
+    int leafSize;
+    int nAlive;
+    std::vector<Node> nodes;
+    std::vector<int> index;           // slot -> point index
+    std::vector<int> slotOf;          // point index -> slot
+    std::vector<int> leafOf;          // slot -> leaf node
+    std::vector<double> xyz;          // coordinates in slot order (x, y, z interleaved)
+    std::vector<char> present;        // per slot
+};
+
+#endif
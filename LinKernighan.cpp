@@ -0,0 +1,270 @@
+// ============================================================================
+// File: LinKernighan.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Lin-Kernighan improvement stage (see LocalSearch.h).
+//
+//   A move starts by breaking a tour edge (t1,t2).  At each level a
+//   candidate neighbour t3 of the free end t2 is joined to it and the edge
+//   (t4,t3) that makes the result a valid tour is broken, which is exactly
+//   one 2-opt flip closing the tour with (t1,t4).  The chain goes on from
+//   t4 while the open gain stays positive; flips past the best closed tour
+//   are undone.  Edges added during a chain are never broken again.
+// ============================================================================
+
+#include "LocalSearch.h"
+#include "Tour.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+// Minimum gain for a move to count as an improvement
+static const double kMinGain = 1e-10;
+
+namespace {
+
+template <class Metric>
+class LinKernighan {
+public:
+    LinKernighan(const EdgeCost<Metric>& dist_, Tour& tour_, const NeighborLists& nbr_, const LKOptions& opt_,
+                 const PathConstraints& cons_, const Deadline& deadline_)
+        : dist(dist_), tour(tour_), nbr(nbr_), opt(opt_), cons(cons_), deadline(deadline_) {}
+
+    // Run LK moves until every don't-look bit is set; returns the total gain
+    double optimize(ActiveQueue& active) {
+        double total = 0.0;
+        while (!active.empty()) {
+            if (deadline.expired()) {
+                timedOut = true;
+                break;
+            }
+            int t1 = active.pop();
+            double gain;
+            if (improveFrom(t1, active, gain)) {
+                total += gain;
+                ++moves;
+                active.push(t1);
+            }
+        }
+        return total;
+    }
+
+    // Iterated LK: perturb, repair locally, keep the result only if it is
+    // shorter.  The moves of a kick that is undone do not count.
+    double kick(mt19937& rng) {
+        size_t mark = journal.size();
+        long movesBefore = moves;
+        keepJournal = true;
+
+        double gain = 0.0;
+        int ends[6];
+        if (!doubleBridge(rng, gain, ends)) {
+            keepJournal = false;
+            return 0.0;
+        }
+        ActiveQueue active(vector<int>(), tour);
+        for (int x : ends) active.push(x);
+        gain += optimize(active);
+
+        keepJournal = false;
+        if (gain <= kMinGain || !active.empty()) {   // no shorter, or repair cut short
+            undoTo(mark);
+            moves = movesBefore;
+            return 0.0;
+        }
+        journal.resize(mark);
+        return gain;
+    }
+
+    long moves = 0;
+    bool timedOut = false;   // a search or the kick loop stopped at the deadline
+
+private:
+    struct Step {
+        int t3, t4;
+        double value;
+    };
+
+    void flip(int t1, int t2, int t4, int t3) {
+        tour.move2opt(t1, t2, t4, t3);
+        journal.push_back({t1, t2, t4, t3});
+    }
+
+    // Undo journaled flips back to the given journal size
+    void undoTo(size_t mark) {
+        while (journal.size() > mark) {
+            const array<int, 4>& f = journal.back();
+            tour.move2opt(f[0], f[2], f[1], f[3]);
+            journal.pop_back();
+        }
+    }
+
+    bool isAdded(int a, int b) const {
+        for (const auto& e : added)
+            if ((e.first == a && e.second == b) || (e.first == b && e.second == a)) return true;
+        return false;
+    }
+
+    // Best (up to 'breadth') next flips from free end t2 with open gain gOpen
+    void candidates(int t1, int t2, double gOpen, int breadth, vector<Step>& out) const {
+        out.clear();
+        bool succ = tour.next(t1) == t2;
+        for (const int* it = nbr.begin(t2); it != nbr.end(t2); ++it) {
+            int t3 = *it;
+            double d23 = dist(t2, t3);
+            if (gOpen - d23 <= kMinGain) break;   // candidates are sorted by cost
+            int t4 = succ ? tour.prev(t3) : tour.next(t3);
+            if (t3 == t1 || t4 == t2 || tour.isFixed(t3, t4) || isAdded(t3, t4)) continue;
+            if (opt.maxFlip > 0 && tour.moveCost(t1, t2, t4, t3) > opt.maxFlip) continue;
+            if (!cons.allowsFlip(tour, t1, t2, t4, t3)) continue;
+
+            Step s = {t3, t4, dist(t3, t4) - d23};
+            auto pos = find_if(out.begin(), out.end(), [&](const Step& o) { return s.value > o.value; });
+            if (static_cast<int>(pos - out.begin()) >= breadth) continue;
+            out.insert(pos, s);
+            if (static_cast<int>(out.size()) > breadth) out.pop_back();
+        }
+    }
+
+    bool improveFrom(int t1, ActiveQueue& active, double& gainOut) {
+        vector<Step> first, next;
+        for (int side = 0; side < 2; ++side) {
+            int t2 = side == 0 ? tour.next(t1) : tour.prev(t1);
+            if (tour.isDepot(t2) || tour.isFixed(t1, t2)) continue;
+
+            candidates(t1, t2, dist(t1, t2), opt.breadth, first);
+            for (const Step& alt : first) {
+                size_t mark = journal.size();
+                size_t bestMark = mark;
+                double actual = 0.0, best = 0.0;
+                added.clear();
+
+                int cur = t2;
+                Step step = alt;
+                for (int depth = 0; depth < opt.maxDepth; ++depth) {
+                    if (deadline.expiredNow()) {
+                        timedOut = true;
+                        break;
+                    }
+                    actual += dist(t1, cur) + dist(step.t4, step.t3)
+                            - dist(cur, step.t3) - dist(t1, step.t4);
+                    flip(t1, cur, step.t4, step.t3);
+                    added.push_back({cur, step.t3});
+                    if (actual > best + kMinGain) {
+                        best = actual;
+                        bestMark = journal.size();
+                    }
+
+                    cur = step.t4;
+                    if (tour.isDepot(cur)) break;
+                    candidates(t1, cur, actual + dist(t1, cur), 1, next);
+                    if (next.empty()) break;
+                    step = next[0];
+                }
+
+                if (bestMark > mark) {
+                    undoTo(bestMark);
+                    for (size_t j = mark; j < bestMark; ++j)
+                        for (int x : journal[j]) active.push(x);
+                    if (!keepJournal) journal.resize(mark);
+                    gainOut = best;
+                    return true;
+                }
+                undoTo(mark);
+            }
+        }
+        return false;
+    }
+
+    // Swap two short consecutive segments after a random point:
+    //   a [b1..bk] [c1..cm] d1  ->  a [c1..cm] [b1..bk] d1
+    // carried out as three 2-opt flips.  Returns false if the chosen spot
+    // touches a fixed end edge, breaks a constraint or the tour is too short.
+    bool doubleBridge(mt19937& rng, double& gain, int ends[6]) {
+        int n = tour.size();
+        int maxSeg = max(1, min(opt.kickSegment, (n - 2) / 2));
+        if (n < 8) return false;
+
+        int a = static_cast<int>(rng() % (n - 1));   // a real point
+        int l1 = 1 + static_cast<int>(rng() % maxSeg);
+        int l2 = 1 + static_cast<int>(rng() % maxSeg);
+
+        int b1 = tour.next(a), bk = b1;
+        for (int k = 1; k < l1; ++k) bk = tour.next(bk);
+        int c1 = tour.next(bk), cm = c1;
+        for (int k = 1; k < l2; ++k) cm = tour.next(cm);
+        int d1 = tour.next(cm);
+        if (d1 == a || tour.isFixed(a, b1) || tour.isFixed(bk, c1) || tour.isFixed(cm, d1)) return false;
+        if (!cons.allowsSwap(tour, b1, bk, c1, cm)) return false;
+
+        gain = dist(a, b1) + dist(bk, c1) + dist(cm, d1)
+             - dist(a, c1) - dist(cm, b1) - dist(bk, d1);
+        flip(a, b1, cm, d1);     // a cm..c1 bk..b1 d1
+        flip(a, cm, c1, bk);     // a c1..cm bk..b1 d1
+        flip(cm, bk, b1, d1);    // a c1..cm b1..bk d1
+
+        int e[6] = {a, b1, bk, c1, cm, d1};
+        copy(e, e + 6, ends);
+        return true;
+    }
+
+    const EdgeCost<Metric>& dist;
+    Tour& tour;
+    const NeighborLists& nbr;
+    const LKOptions& opt;
+    const PathConstraints& cons;
+    const Deadline& deadline;
+
+    vector<array<int, 4>> journal;       // flips that may still be undone
+    vector<pair<int, int>> added;        // edges added by the current chain
+    bool keepJournal = false;
+};
+
+}
+
+//------------------------------------------------------------------------------
+// Entry point
+//------------------------------------------------------------------------------
+template <class Metric>
+PassReport linKernighan(const PointSet& pts, vector<int>& order,
+                        const NeighborLists& nbr, const LKOptions& opt, const PathEnds& ends,
+                        const PathConstraints& cons, const Deadline& deadline, const Metric& metric) {
+    PassReport rep;
+    if (order.size() < 3 || nbr.k == 0) return rep;
+    auto t0 = chrono::steady_clock::now();
+
+    EdgeCost<Metric> dist(pts, metric, ends.closed ? order[0] : -1, cons);
+    Tour tour(order, ends.end >= 0);
+    LinKernighan<Metric> lk(dist, tour, nbr, opt, cons, deadline);
+
+    ActiveQueue active(order, tour);
+    rep.gain = lk.optimize(active);
+
+    mt19937 rng(opt.seed);
+    long maxKicks = opt.kicks >= 0 ? opt.kicks : deadline.isLimited() ? -1 : 0;
+    for (; maxKicks < 0 || rep.kicks < maxKicks; ++rep.kicks) {
+        if (deadline.expiredNow()) {
+            lk.timedOut = true;
+            break;
+        }
+        rep.gain += lk.kick(rng);
+    }
+
+    rep.moves = lk.moves;
+    rep.timedOut = lk.timedOut;
+    order = tour.path();
+    rep.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return rep;
+}
+
+#define INSTANTIATE(M)                                                                             \
+    template PassReport linKernighan<M>(const PointSet&, vector<int>&, const NeighborLists&,       \
+                                        const LKOptions&, const PathEnds&, const PathConstraints&, \
+                                        const Deadline&, const M&);
+PATHOPT_FOR_EACH_METRIC(INSTANTIATE)
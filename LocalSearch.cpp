@@ -0,0 +1,311 @@
+// ============================================================================
+// File: LocalSearch.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Candidate lists and local-search improvement stages (see LocalSearch.h).
+// ============================================================================
+
+#include "LocalSearch.h"
+#include "KdTree.h"
+#include "Tour.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+// Minimum gain for a move to count as an improvement
+static const double kMinGain = 1e-10;
+
+//------------------------------------------------------------------------------
+// Candidate lists
+//------------------------------------------------------------------------------
+template <class Metric>
+NeighborLists buildNeighborLists(const PointSet& pts, int k, const PathConstraints& cons,
+                                 const Deadline& deadline, const Metric& metric) {
+    NeighborLists nbr;
+    int n = static_cast<int>(pts.size());
+    nbr.k = max(0, min(k, n - 1));
+    nbr.idx.resize(size_t(n) * nbr.k);
+    if (nbr.k == 0) return nbr;
+
+    KdTree<Metric> tree(pts, metric);
+    vector<int> found;
+    if (!cons.hasTools()) {
+        for (int i = 0; i < n; ++i) {
+            if (deadline.expired()) return NeighborLists();
+            tree.kNearest(i, nbr.k, found);
+            if constexpr (Metric::hasPointCost) {
+                // Chosen by key, but ordered by the cost of the move: the
+                // stages stop at the first candidate that is too expensive
+                stable_sort(found.begin(), found.end(), [&](int a, int b) {
+                    return moveCost(metric, pts, i, a) < moveCost(metric, pts, i, b);
+                });
+            }
+            copy(found.begin(), found.end(), nbr.idx.begin() + size_t(i) * nbr.k);
+        }
+        return nbr;
+    }
+
+    // One tree per tool over copies of its points (local index -> point)
+    int tools = cons.toolCount();
+    vector<vector<int>> members(tools);
+    vector<int> local(n);
+    for (int i = 0; i < n; ++i) {
+        local[i] = static_cast<int>(members[cons.toolOf(i)].size());
+        members[cons.toolOf(i)].push_back(i);
+    }
+    vector<KdTree<Metric>> toolTree;
+    toolTree.reserve(tools);
+    for (int t = 0; t < tools; ++t) toolTree.emplace_back(PointSet(pts, members[t]), metric);
+
+    vector<pair<double, int>> merged;
+    for (int i = 0; i < n; ++i) {
+        if (deadline.expired()) return NeighborLists();
+        merged.clear();
+        tree.kNearest(i, nbr.k, found);
+        for (int j : found) merged.push_back({moveCost(metric, pts, i, j) + cons.changeCost(i, j), j});
+        const vector<int>& same = members[cons.toolOf(i)];
+        toolTree[cons.toolOf(i)].kNearest(local[i], nbr.k, found);
+        for (int j : found) merged.push_back({moveCost(metric, pts, i, same[j]), same[j]});
+        sort(merged.begin(), merged.end());
+        merged.erase(unique(merged.begin(), merged.end()), merged.end());
+
+        int* out = nbr.idx.data() + size_t(i) * nbr.k;
+        for (int j = 0; j < nbr.k; ++j) out[j] = merged[j].second;
+    }
+    return nbr;
+}
+
+//------------------------------------------------------------------------------
+// 2-opt
+//
+// For a point a and its tour neighbour b (successor, then predecessor), try
+// every candidate c closer to a than b is.  With d the neighbour of c on the
+// same side, replacing edges (a,b) and (c,d) by (a,c) and (b,d) is a 2-opt
+// move, applied as one segment reversal.
+//------------------------------------------------------------------------------
+template <class Metric>
+PassReport twoOpt(const PointSet& pts, vector<int>& order, const NeighborLists& nbr,
+                  const PathEnds& ends, const PathConstraints& cons, const Deadline& deadline,
+                  const Metric& metric) {
+    PassReport rep;
+    if (order.size() < 3 || nbr.k == 0) return rep;
+
+    EdgeCost<Metric> dist(pts, metric, ends.closed ? order[0] : -1, cons);
+    Tour tour(order, ends.end >= 0);
+    ActiveQueue active(order, tour);
+
+    while (!active.empty() && !deadline.expired()) {
+        int a = active.pop();
+        bool improved = false;
+
+        for (int dir = 0; dir < 2 && !improved; ++dir) {
+            bool succ = dir == 0;
+            int b = succ ? tour.next(a) : tour.prev(a);
+            if (tour.isFixed(a, b)) continue;
+            double dab = dist(a, b);
+
+            for (const int* it = nbr.begin(a); it != nbr.end(a); ++it) {
+                int c = *it;
+                double g1 = dab - dist(a, c);
+                if (g1 <= kMinGain) break;   // candidates are sorted by cost
+
+                int d = succ ? tour.next(c) : tour.prev(c);
+                if (c == b || d == a || tour.isFixed(c, d)) continue;
+
+                double gain = g1 + dist(c, d) - dist(b, d);
+                if (gain > kMinGain && cons.allowsFlip(tour, a, b, c, d)) {
+                    tour.move2opt(a, b, c, d);
+                    active.push(a);
+                    active.push(b);
+                    active.push(c);
+                    active.push(d);
+                    ++rep.moves;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    rep.timedOut = !active.empty();   // only the deadline leaves points queued
+    order = tour.path();
+    return rep;
+}
+
+//------------------------------------------------------------------------------
+// Or-opt
+//
+// A segment s1..s2 (1-3 points, in tour direction) is cut out between p and
+// nx and re-inserted into another tour edge (u,v), with v the successor of
+// u in the same direction.  The move is carried out as two or three 2-opt
+// moves:
+//
+//   p s1..s2 nx..u v   ->  p u..nx s2..s1 v     (p,s1)+(u,v)
+//                      ->  p nx..u s2..s1 v     (p,u)+(nx,s2)
+//                      ->  p nx..u s1..s2 v     (u,s2)+(s1,v), if not reversed
+//------------------------------------------------------------------------------
+namespace {
+struct OrMove {
+    double gain = 0.0;
+    int s1 = -1, s2 = -1, p = -1, nx = -1, u = -1, v = -1;
+    bool reversed = false;
+};
+}
+
+static void applyOrMove(Tour& tour, OrMove m) {
+    // Insertion just before p: mirror the move so that the target edge is
+    // the one after nx
+    if (m.v == m.p) {
+        swap(m.s1, m.s2);
+        swap(m.p, m.nx);
+        swap(m.u, m.v);
+    }
+    tour.move2opt(m.p, m.s1, m.u, m.v);
+    if (m.u != m.nx) tour.move2opt(m.p, m.u, m.nx, m.s2);
+    if (!m.reversed && m.s1 != m.s2) tour.move2opt(m.u, m.s2, m.s1, m.v);
+}
+
+template <class Metric>
+vector<PassReport> orOpt(const PointSet& pts, vector<int>& order, const NeighborLists& nbr,
+                         const PathEnds& ends, const PathConstraints& cons, const Deadline& deadline,
+                         const Metric& metric) {
+    vector<PassReport> reports;
+    if (order.size() < 3 || nbr.k == 0) return reports;
+
+    EdgeCost<Metric> dist(pts, metric, ends.closed ? order[0] : -1, cons);
+    Tour tour(order, ends.end >= 0);
+    vector<int> current(order.begin(), order.end()), pending;
+    vector<char> queued(tour.size(), 1);
+    queued[tour.depot()] = 0;
+
+    auto push = [&](int a) {
+        if (!tour.isDepot(a) && !queued[a]) {
+            queued[a] = 1;
+            pending.push_back(a);
+        }
+    };
+
+    while (!current.empty()) {
+        auto t0 = chrono::steady_clock::now();
+        PassReport rep;
+
+        for (int a : current) {
+            if (deadline.expired()) {
+                rep.timedOut = true;
+                break;
+            }
+            queued[a] = 0;
+            OrMove best;
+
+            // Segments of length 1-3 that start or end at a
+            for (int len = 1; len <= 3; ++len) {
+                for (int side = 0; side < (len == 1 ? 1 : 2); ++side) {
+                    int s1 = a, s2 = a;
+                    bool valid = true;
+                    for (int k = 1; k < len && valid; ++k) {
+                        if (side == 0) s2 = tour.next(s2);
+                        else           s1 = tour.prev(s1);
+                        valid = !tour.isDepot(s1) && !tour.isDepot(s2);
+                    }
+                    if (!valid) continue;
+                    int p = tour.prev(s1), nx = tour.next(s2);
+                    if (p == s2 || nx == s1 || p == nx) continue;   // segment spans the tour
+                    if (tour.isFixed(p, s1) || tour.isFixed(s2, nx)) continue;
+
+                    double removeGain = dist(p, s1) + dist(s2, nx) - dist(p, nx);
+                    if (removeGain <= best.gain + kMinGain) continue;
+
+                    int seg[3] = {s1, s1, s1};
+                    for (int k = 1; k < len; ++k) seg[k] = tour.next(seg[k - 1]);
+                    auto inSegment = [&](int x) { return x == seg[0] || x == seg[1] || x == seg[2]; };
+
+                    for (int e : {s1, s2}) {
+                        for (const int* it = nbr.begin(e); it != nbr.end(e); ++it) {
+                            int c = *it;
+                            if (dist(e, c) >= removeGain - best.gain) break;
+                            if (inSegment(c)) continue;
+
+                            for (int w = 0; w < 2; ++w) {
+                                int u = w == 0 ? c : tour.prev(c);
+                                int v = w == 0 ? tour.next(c) : c;
+                                if (inSegment(u) || inSegment(v) || tour.isFixed(u, v)) continue;
+                                if (u == nx && v == p) continue;   // same place, three-node tour
+
+                                double duv = dist(u, v);
+                                double fwd = dist(u, s1) + dist(s2, v) - duv;
+                                double rev = dist(u, s2) + dist(s1, v) - duv;
+                                double gain = removeGain - min(fwd, rev);
+                                if (gain > best.gain + kMinGain &&
+                                    cons.allowsMove(tour, s1, s2, p, nx, u, v, rev < fwd)) {
+                                    best.gain = gain;
+                                    best.s1 = s1; best.s2 = s2;
+                                    best.p = p;   best.nx = nx;
+                                    best.u = u;   best.v = v;
+                                    best.reversed = rev < fwd;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (best.s1 >= 0) {
+                applyOrMove(tour, best);
+                for (int x : {best.p, best.nx, best.s1, best.s2, best.u, best.v}) push(x);
+                ++rep.moves;
+                rep.gain += best.gain;
+            }
+        }
+
+        rep.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        if (rep.moves == 0 && !rep.timedOut) break;
+        reports.push_back(rep);
+        if (rep.timedOut) break;
+        if (deadline.expired()) {
+            reports.back().timedOut = !pending.empty();
+            break;
+        }
+        current.swap(pending);
+        pending.clear();
+    }
+
+    order = tour.path();
+    return reports;
+}
+
+//------------------------------------------------------------------------------
+// Pipeline
+//------------------------------------------------------------------------------
+template <class Metric>
+bool improvePath(const PointSet& pts, vector<int>& order, const NeighborLists& nbr,
+                 const ImproveOptions& opt, const PathEnds& ends, const PathConstraints& cons,
+                 const Deadline& deadline, const Metric& metric) {
+    bool timedOut = false;
+    if (opt.improver == Improver::TwoOpt)
+        timedOut = twoOpt(pts, order, nbr, ends, cons, deadline, metric).timedOut;
+    else if (opt.improver == Improver::LinKernighan)
+        timedOut = linKernighan(pts, order, nbr, opt.lk, ends, cons, deadline, metric).timedOut;
+    if (opt.orOpt) {
+        vector<PassReport> passes = orOpt(pts, order, nbr, ends, cons, deadline, metric);
+        if (!passes.empty() && passes.back().timedOut) timedOut = true;
+    }
+    return timedOut;
+}
+
+#define INSTANTIATE(M)                                                                             \
+    template NeighborLists buildNeighborLists<M>(const PointSet&, int, const PathConstraints&,     \
+                                                 const Deadline&, const M&);                       \
+    template PassReport twoOpt<M>(const PointSet&, vector<int>&, const NeighborLists&,             \
+                                  const PathEnds&, const PathConstraints&, const Deadline&,        \
+                                  const M&);                                                       \
+    template vector<PassReport> orOpt<M>(const PointSet&, vector<int>&, const NeighborLists&,      \
+                                         const PathEnds&, const PathConstraints&, const Deadline&, \
+                                         const M&);                                                \
+    template bool improvePath<M>(const PointSet&, vector<int>&, const NeighborLists&,              \
+                                 const ImproveOptions&, const PathEnds&, const PathConstraints&,   \
+                                 const Deadline&, const M&);
+PATHOPT_FOR_EACH_METRIC(INSTANTIATE)
@@ -0,0 +1,219 @@
+// ============================================================================
+// File: LocalSearch.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Improvement stages run on the order produced by optimizePath().
+//
+//   Moves are only tried between a point and its K nearest neighbours
+//   (candidate lists), and every point carries a "don't-look bit": a point
+//   is only re-examined after one of its tour edges has changed.  Together
+//   these keep each pass close to linear in the number of points instead of
+//   the O(n^2) of an exhaustive search.
+//
+//   All stages keep the first point of the order as the start of the path;
+//   the end of the path is free unless PathEnds fixes it (it must then be
+//   the last point of the order), and for a closed path the return to the
+//   start is charged like any other move.  With visiting-order constraints
+//   (PathConstraints.h) the order a stage gets must satisfy them, and only
+//   moves that keep it feasible are applied.  Every stage also takes a
+//   Deadline and returns early, with a valid and never longer order, once it
+//   expires.
+//
+//   Like the greedy construction, every stage is a template on the distance
+//   metric (Metric.h), instantiated for each policy in the .cpp files.
+// ============================================================================
+
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include <deque>
+#include <vector>
+
+#include "PointSet.h"
+#include "Metric.h"
+#include "Deadline.h"
+#include "PathEnds.h"
+#include "PathConstraints.h"
+#include "Tour.h"
+
+// K nearest neighbours of every point, cheapest move first (point costs and
+// tool changes included, as in EdgeCost below): the stages stop scanning a
+// list at the first candidate that cannot give a gain
+struct NeighborLists {
+    int k = 0;
+    std::vector<int> idx;   // idx[i * k + j] = j-th neighbour of point i
+
+    const int* begin(int i) const { return idx.data() + size_t(i) * k; }
+    const int* end(int i) const { return begin(i) + k; }
+};
+
+// With tools (PathConstraints::setTools) each list mixes the nearest points
+// of the same tool into the nearest points overall and keeps the k cheapest
+// moves, tool change included, so that the stages still see same-tool
+// neighbours where tools are interleaved.  Returns empty lists (k = 0, which
+// turns every stage into a no-op) if the deadline expires while they are
+// being built.
+template <class Metric = Euclidean3D>
+NeighborLists buildNeighborLists(const PointSet& pts, int k,
+                                 const PathConstraints& cons = PathConstraints(),
+                                 const Deadline& deadline = Deadline(),
+                                 const Metric& metric = Metric());
+
+// Edge costs between tour nodes under the given metric, point costs and
+// tool changes (PathConstraints.h) included.  Edges to the depot node (index
+// n, see Tour.h) are free, or with returnTo >= 0 (a closed path) cost the
+// move back to that point.  The local searches look edges up in tour order,
+// i.e. at random, so the coordinates are re-interleaved here to cost one
+// cache line per endpoint instead of three.
+template <class Metric = Euclidean3D>
+class EdgeCost {
+public:
+    explicit EdgeCost(const PointSet& pts, const Metric& metric_ = Metric(), int returnTo_ = -1,
+                      const PathConstraints& cons = PathConstraints())
+        : metric(metric_), n(static_cast<int>(pts.size())), returnTo(returnTo_), xyz(3 * pts.size()) {
+        for (size_t i = 0; i < pts.size(); ++i) {
+            xyz[3 * i]     = pts.x[i];
+            xyz[3 * i + 1] = pts.y[i];
+            xyz[3 * i + 2] = pts.z[i];
+        }
+        if constexpr (Metric::hasPointCost) {
+            pc.resize(pts.size());
+            for (size_t i = 0; i < pts.size(); ++i) pc[i] = metric.pointCost(pts.z[i]);
+        }
+        if (cons.hasTools()) {
+            change = cons.toolChangeCost();
+            tool.resize(pts.size());
+            for (int i = 0; i < n; ++i) tool[i] = cons.toolOf(i);
+        }
+    }
+
+    double operator()(int a, int b) const {
+        if (a == n || b == n) {
+            if (returnTo < 0) return 0.0;
+            a = a == n ? b : a;
+            b = returnTo;
+            if (a == b) return 0.0;
+        }
+        const double* p = &xyz[3 * size_t(a)];
+        const double* q = &xyz[3 * size_t(b)];
+        double c = metric.distance(q[0] - p[0], q[1] - p[1], q[2] - p[2]);
+        if constexpr (Metric::hasPointCost) c += pc[a] + pc[b];
+        if (change > 0.0 && tool[a] != tool[b]) c += change;
+        return c;
+    }
+
+private:
+    Metric metric;
+    int n;
+    int returnTo;
+    std::vector<double> xyz;
+    std::vector<double> pc;   // point costs, if the metric has them
+    double change = 0.0;      // cost of a tool change, if there are tools
+    std::vector<int> tool;
+};
+
+// FIFO of points whose don't-look bit is off.  The depot of the tour is
+// never queued: it has no neighbour list, and its edges are only moved from
+// the point side.
+class ActiveQueue {
+public:
+    ActiveQueue(const std::vector<int>& order, const Tour& tour)
+        : queued(tour.size(), 0), depot(tour.depot()) {
+        for (int a : order) push(a);
+    }
+    void push(int a) {
+        if (a != depot && !queued[a]) {
+            queued[a] = 1;
+            q.push_back(a);
+        }
+    }
+    bool empty() const { return q.empty(); }
+    int pop() {
+        int a = q.front();
+        q.pop_front();
+        queued[a] = 0;
+        return a;
+    }
+
+private:
+    std::deque<int> q;
+    std::vector<char> queued;
+    int depot;
+};
+
+// Progress of one pass of an improvement stage
+struct PassReport {
+    long moves = 0;
+    double gain = 0.0;      // reduction of the path length
+    double seconds = 0.0;
+    long kicks = 0;         // perturbations tried (iterated LK only)
+    bool timedOut = false;  // stopped at the deadline with work left
+};
+
+// 2-opt edge exchange with neighbour lists and don't-look bits.  Improves
+// 'order' in place; the report gives the number of moves applied and
+// whether the deadline stopped it.
+template <class Metric = Euclidean3D>
+PassReport twoOpt(const PointSet& pts, std::vector<int>& order, const NeighborLists& nbr,
+                  const PathEnds& ends = PathEnds(), const PathConstraints& cons = PathConstraints(),
+                  const Deadline& deadline = Deadline(), const Metric& metric = Metric());
+
+// Or-opt: relocate segments of 1-3 consecutive points, possibly reversed,
+// next to one of the candidate neighbours of their end points.  Improves
+// 'order' in place and returns one report per pass; a pass handles every
+// point whose don't-look bit was off when the pass started.  A pass cut
+// short by the deadline is reported even if it found no move.
+template <class Metric = Euclidean3D>
+std::vector<PassReport> orOpt(const PointSet& pts, std::vector<int>& order,
+                              const NeighborLists& nbr, const PathEnds& ends = PathEnds(),
+                              const PathConstraints& cons = PathConstraints(),
+                              const Deadline& deadline = Deadline(),
+                              const Metric& metric = Metric());
+
+// Lin-Kernighan settings
+struct LKOptions {
+    int maxDepth = 50;      // flips per move
+    int breadth = 5;        // alternatives tried for the first flip
+    int maxFlip = 0;        // longest segment reversal considered (0 = any)
+    long kicks = 0;         // segment-local double-bridge perturbations
+                            // (-1 = keep kicking until a limited deadline)
+    int kickSegment = 50;   // maximum length of the two swapped segments
+    unsigned seed = 1;      // random generator seed for the kicks
+};
+
+// Variable-depth Lin-Kernighan search.  Each move is a chain of 2-opt flips
+// on the array tour, grown from a point with an off don't-look bit while
+// the cumulative gain allows it; the best prefix of the chain is kept.
+// With opt.kicks > 0 the local optimum is then perturbed by small
+// double-bridge kicks, each followed by a local LK repair and undone unless
+// the path got shorter (iterated LK).  Improves 'order' in place; the report
+// covers the whole run, counting the moves of the kept kicks only.
+template <class Metric = Euclidean3D>
+PassReport linKernighan(const PointSet& pts, std::vector<int>& order,
+                        const NeighborLists& nbr, const LKOptions& opt = LKOptions(),
+                        const PathEnds& ends = PathEnds(),
+                        const PathConstraints& cons = PathConstraints(),
+                        const Deadline& deadline = Deadline(), const Metric& metric = Metric());
+
+// Improvement pipeline: the main stage followed by an optional Or-opt stage
+enum class Improver { None, TwoOpt, LinKernighan };
+
+struct ImproveOptions {
+    Improver improver = Improver::TwoOpt;
+    bool orOpt = false;
+    LKOptions lk;
+};
+
+// Run the configured stages silently on 'order' (used for multi-start runs,
+// where per-stage reports would be meaningless).  Returns true if one of
+// them stopped at the deadline.
+template <class Metric = Euclidean3D>
+bool improvePath(const PointSet& pts, std::vector<int>& order, const NeighborLists& nbr,
+                 const ImproveOptions& opt, const PathEnds& ends = PathEnds(),
+                 const PathConstraints& cons = PathConstraints(),
+                 const Deadline& deadline = Deadline(),
+                 const Metric& metric = Metric());
+
+#endif
@@ -0,0 +1,66 @@
+// ============================================================================
+// File: MachineModel.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Machine config file reader (see MachineModel.h).
+// ============================================================================
+
+#include "MachineModel.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+bool loadMachineModel(const string& path, MachineModel& model, string& error) {
+    ifstream in(path);
+    if (!in) {
+        error = path + ": cannot open machine config";
+        return false;
+    }
+
+    MachineModel m = model;
+    string line;
+    for (int lineNo = 1; getline(in, line); ++lineNo) {
+        line = line.substr(0, line.find('#'));
+        istringstream fields(line);
+        string key;
+        if (!(fields >> key)) continue;   // blank or comment
+
+        vector<double> v;
+        double d;
+        while (fields >> d) v.push_back(d);
+        string where = path + ":" + to_string(lineNo) + ": ";
+        if (!fields.eof() || (v.size() != 1 && v.size() != 3)) {
+            error = where + "'" + key + "' needs one value or three (X Y Z)";
+            return false;
+        }
+        if (v.size() == 1) v.assign(3, v[0]);
+
+        for (int k = 0; k < 3; ++k) {
+            AxisLimits& a = m.axis[k];
+            if (key == "velocity" || key == "acceleration") {
+                if (!(v[k] > 0.0)) {
+                    error = where + key + " must be positive";
+                    return false;
+                }
+                (key == "velocity" ? a.velocity : a.acceleration) = v[k];
+            } else if (key == "settle") {
+                if (!(v[k] >= 0.0)) {
+                    error = where + "settle must not be negative";
+                    return false;
+                }
+                a.settle = v[k];
+            } else {
+                error = where + "unknown setting '" + key + "' (use velocity, acceleration or settle)";
+                return false;
+            }
+        }
+    }
+
+    model = m;
+    return true;
+}
@@ -0,0 +1,40 @@
+// ============================================================================
+// File: MachineModel.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Axis limits of the measuring machine, used by the travel-time metric
+//   (TravelTime in Metric.h, --machine).  The axes move simultaneously, each
+//   from rest to rest with a trapezoidal velocity profile (constant
+//   acceleration up to its maximum velocity, cruise, symmetric braking) and
+//   then settles; a move is over when the last axis has settled.
+//
+//   Machine config file (one setting per line, '#' starts a comment; one
+//   value applies to all three axes, three values are X, Y and Z):
+//       # CMM, coordinates in mm
+//       velocity      400 400 250     # mm/s
+//       acceleration  2000 2000 1000  # mm/s^2
+//       settle        0.05            # s, after an axis has stopped
+// ============================================================================
+
+#ifndef MACHINEMODEL_H
+#define MACHINEMODEL_H
+
+#include <string>
+
+struct AxisLimits {
+    double velocity = 1.0;       // coordinate units per second
+    double acceleration = 1.0;   // coordinate units per second^2
+    double settle = 0.0;         // seconds, added when the axis has moved
+};
+
+struct MachineModel {
+    AxisLimits axis[3];   // X, Y, Z
+};
+
+// Read a machine config file.  On failure returns false and sets error to a
+// message naming the file and line; 'model' is then left unchanged.
+bool loadMachineModel(const std::string& path, MachineModel& model, std::string& error);
+
+#endif
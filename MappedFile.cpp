@@ -0,0 +1,107 @@
+// ============================================================================
+// File: MappedFile.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Memory-mapped input files (see MappedFile.h).
+// ============================================================================
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        ptr = other.ptr;
+        len = other.len;
+        mapped = other.mapped;
+        device = other.device;
+        inode = other.inode;
+        buffer = move(other.buffer);
+        err = move(other.err);
+        if (!mapped) ptr = buffer.data();
+        other.ptr = nullptr;
+        other.len = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+    if (mapped) munmap(const_cast<char*>(ptr), len);
+    ptr = nullptr;
+    len = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool MappedFile::isMapping(const string& path) const {
+    struct stat st;
+    return mapped && stat(path.c_str(), &st) == 0 && static_cast<unsigned long long>(st.st_dev) == device &&
+           static_cast<unsigned long long>(st.st_ino) == inode;
+}
+
+bool MappedFile::open(const string& path) {
+    release();
+    err.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        err = "cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        len = static_cast<size_t>(st.st_size);
+        if (len == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, len, MADV_SEQUENTIAL);
+            ptr = static_cast<const char*>(p);
+            mapped = true;
+            device = st.st_dev;
+            inode = st.st_ino;
+            ::close(fd);
+            return true;
+        }
+        len = 0;
+    }
+
+    // Not mappable: read everything
+    char chunk[1 << 16];
+    for (;;) {
+        ssize_t got = ::read(fd, chunk, sizeof(chunk));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            err = "cannot read " + path + ": " + strerror(errno);
+            ::close(fd);
+            buffer.clear();
+            return false;
+        }
+        if (got == 0) break;
+        buffer.insert(buffer.end(), chunk, chunk + got);
+    }
+    ::close(fd);
+    ptr = buffer.data();
+    len = buffer.size();
+    return true;
+}
@@ -0,0 +1,53 @@
+// ============================================================================
+// File: MappedFile.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Read-only view of a whole input file.  Regular files are memory-mapped;
+//   anything that cannot be mapped (pipes, special files) is read into a
+//   buffer instead, so callers always see one contiguous byte range.
+// ============================================================================
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Replaces the current contents.  On failure returns false and sets
+    // error() to a message naming the file.
+    bool open(const std::string& path);
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+    const std::string& error() const { return err; }
+
+    // True if the file is mapped and path names that same file.  Truncating
+    // a mapped file makes reads of the lost pages fault, so callers must not
+    // overwrite it in place while views into data() are alive.
+    bool isMapping(const std::string& path) const;
+
+private:
+    void release();
+
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+    bool mapped = false;
+    unsigned long long device = 0, inode = 0;   // of the mapped file
+    std::vector<char> buffer;   // contents when not mapped
+    std::string err;
+};
+
+#endif
@@ -0,0 +1,260 @@
+// ============================================================================
+// File: Metric.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Distance metrics as compile-time policies.  Every optimizer stage is a
+//   template on one of the policy types below and is instantiated once per
+//   metric inside libpathopt, so the distance in the inner loops is fully
+//   inlined; the metric chosen at run time (--metric) is dispatched once, by
+//   withMetric(), at the top of the pipeline.  The stages take the policy
+//   by value as their last argument, so a policy may carry parameters (the
+//   machine model of TravelTime); the geometric ones are empty.
+//
+//   A policy provides
+//       key(dx, dy, dz)   a cheap value that orders distances the same way
+//                         as the distance itself (the squared distance for
+//                         the Euclidean metrics); the searches compare keys,
+//                         and a key of per-axis box gaps is a lower bound for
+//                         the k-d tree
+//       length(key)       the distance belonging to a key
+//       distance(dx, dy, dz)
+//   and, when hasPointCost is set, pointCost(z): a cost paid on leaving and
+//   again on reaching a point, which depends on the point itself rather than
+//   on the move (the retract and approach of the clearance-plane models).
+//   The cost of the move a -> b is then
+//       distance(b - a) + pointCost(z_a) + pointCost(z_b)
+//   (moveCost() below).  Such costs cancel in any exchange that keeps every
+//   point inside the path, so the candidate lists are chosen by the keys
+//   alone (and only ordered by the move cost, which the partial gains of
+//   2-opt and LK include); they matter to the greedy step, which adds
+//   pointCost to the keys (these policies have linear keys), and at the free
+//   end of the path.  pointCost must not increase with z, which gives the
+//   k-d tree its bound.
+//
+//   Per-axis weights multiply the coordinate differences before the metric
+//   is applied, e.g. sqrt((wx dx)^2 + (wy dy)^2 + (wz dz)^2).  They are
+//   applied once by scaling the coordinates (weightedPoints()), which gives
+//   every metric a weighted variant at no cost per distance.
+// ============================================================================
+
+#ifndef METRIC_H
+#define METRIC_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "PointSet.h"
+#include "MachineModel.h"
+
+struct Euclidean3D {
+    static constexpr const char* name = "euclid3d";
+    static constexpr bool squaredEuclidean = true;   // brute force may use DistanceKernels.h
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = false;
+    static double key(double dx, double dy, double dz) { return dx * dx + dy * dy + dz * dz; }
+    static double length(double key) { return std::sqrt(key); }
+    static double distance(double dx, double dy, double dz) { return length(key(dx, dy, dz)); }
+};
+
+// Distance in the XY plane; Z is ignored
+struct Euclidean2D {
+    static constexpr const char* name = "euclid2d";
+    static constexpr bool squaredEuclidean = true;
+    static constexpr bool usesZ = false;
+    static constexpr bool hasPointCost = false;
+    static double key(double dx, double dy, double) { return dx * dx + dy * dy; }
+    static double length(double key) { return std::sqrt(key); }
+    static double distance(double dx, double dy, double dz) { return length(key(dx, dy, dz)); }
+};
+
+// Sum of the axis distances (axes moved one after the other)
+struct Manhattan {
+    static constexpr const char* name = "manhattan";
+    static constexpr bool squaredEuclidean = false;
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = false;
+    static double key(double dx, double dy, double dz) {
+        return std::fabs(dx) + std::fabs(dy) + std::fabs(dz);
+    }
+    static double length(double key) { return key; }
+    static double distance(double dx, double dy, double dz) { return key(dx, dy, dz); }
+};
+
+// Largest axis distance (axes moved simultaneously at equal speed)
+struct Chebyshev {
+    static constexpr const char* name = "chebyshev";
+    static constexpr bool squaredEuclidean = false;
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = false;
+    static double key(double dx, double dy, double dz) {
+        return std::max(std::max(std::fabs(dx), std::fabs(dy)), std::fabs(dz));
+    }
+    static double length(double key) { return key; }
+    static double distance(double dx, double dy, double dz) { return key(dx, dy, dz); }
+};
+
+// Estimated move time in seconds on the machine described by a MachineModel:
+// the time of the slowest axis, including its settle time.  Each axis time
+// only grows with the axis distance, so the time of the per-axis box gaps is
+// still a valid k-d tree bound.
+class TravelTime {
+public:
+    static constexpr const char* name = "time";
+    static constexpr bool squaredEuclidean = false;
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = false;
+
+    explicit TravelTime(const MachineModel& m = MachineModel()) {
+        for (int k = 0; k < 3; ++k) {
+            const AxisLimits& a = m.axis[k];
+            ax[k].invVelocity = 1.0 / a.velocity;
+            ax[k].invAcceleration = 1.0 / a.acceleration;
+            ax[k].rampDistance = a.velocity * a.velocity / a.acceleration;
+            ax[k].rampTime = a.velocity / a.acceleration;
+            ax[k].settle = a.settle;
+        }
+    }
+
+    double key(double dx, double dy, double dz) const {
+        return std::max(std::max(axisTime(0, dx), axisTime(1, dy)), axisTime(2, dz));
+    }
+    static double length(double key) { return key; }
+    double distance(double dx, double dy, double dz) const { return key(dx, dy, dz); }
+
+    // Rest-to-rest time of one axis: d/v + v/a once the axis reaches its
+    // maximum velocity (d >= v^2/a), 2 sqrt(d/a) on a triangular profile
+    double axisTime(int k, double d) const {
+        const Axis& a = ax[k];
+        d = std::fabs(d);
+        if (d == 0.0) return 0.0;
+        double t = d >= a.rampDistance ? d * a.invVelocity + a.rampTime
+                                       : 2.0 * std::sqrt(d * a.invAcceleration);
+        return t + a.settle;
+    }
+
+private:
+    struct Axis {
+        double invVelocity, invAcceleration, rampDistance, rampTime, settle;
+    };
+    Axis ax[3];
+};
+
+// Probe moves through a clearance plane: retract straight up from the point
+// to Z = clearance, move in XY, descend onto the next point.  Points at or
+// above the plane are left and reached in XY only.
+class Retract {
+public:
+    static constexpr const char* name = "retract";
+    static constexpr bool squaredEuclidean = false;
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = true;
+
+    explicit Retract(double clearance_ = 0.0) : clearance(clearance_) {}
+
+    static double key(double dx, double dy, double) { return std::sqrt(dx * dx + dy * dy); }
+    static double length(double key) { return key; }
+    static double distance(double dx, double dy, double dz) { return key(dx, dy, dz); }
+    double pointCost(double z) const { return std::max(0.0, clearance - z); }
+
+private:
+    double clearance;
+};
+
+// Time of the same retract, XY and approach sequence on a machine: the XY
+// move takes as long as the slower of X and Y, retract and approach are
+// Z moves of their own
+class RetractTime {
+public:
+    static constexpr const char* name = "retract-time";
+    static constexpr bool squaredEuclidean = false;
+    static constexpr bool usesZ = true;
+    static constexpr bool hasPointCost = true;
+
+    explicit RetractTime(const MachineModel& m = MachineModel(), double clearance_ = 0.0)
+        : time(m), clearance(clearance_) {}
+
+    double key(double dx, double dy, double) const {
+        return std::max(time.axisTime(0, dx), time.axisTime(1, dy));
+    }
+    static double length(double key) { return key; }
+    double distance(double dx, double dy, double dz) const { return key(dx, dy, dz); }
+    double pointCost(double z) const { return time.axisTime(2, std::max(0.0, clearance - z)); }
+
+private:
+    TravelTime time;
+    double clearance;
+};
+
+// Cost of the move from point a to point b, including the point costs
+template <class Metric>
+inline double moveCost(const Metric& metric, const PointSet& pts, int a, int b) {
+    double c = metric.distance(pts.x[b] - pts.x[a], pts.y[b] - pts.y[a], pts.z[b] - pts.z[a]);
+    if constexpr (Metric::hasPointCost) c += metric.pointCost(pts.z[a]) + metric.pointCost(pts.z[b]);
+    return c;
+}
+
+// X-macro listing every policy, used for the explicit instantiations
+#define PATHOPT_FOR_EACH_METRIC(X) \
+    X(Euclidean3D) X(Euclidean2D) X(Manhattan) X(Chebyshev) X(TravelTime) X(Retract) X(RetractTime)
+
+enum class MetricKind { Euclidean3D, Euclidean2D, Manhattan, Chebyshev, TravelTime, Retract, RetractTime };
+
+struct MetricOptions {
+    MetricKind kind = MetricKind::Euclidean3D;
+    double weights[3] = {1.0, 1.0, 1.0};   // X, Y, Z
+    MachineModel machine;                  // TravelTime and RetractTime
+    double clearance = 0.0;                // Retract and RetractTime: Z of the clearance plane
+
+    bool weighted() const { return weights[0] != 1.0 || weights[1] != 1.0 || weights[2] != 1.0; }
+};
+
+// Call f(policy) with the policy selected by opt.kind
+template <class F>
+auto withMetric(const MetricOptions& opt, F&& f) {
+    switch (opt.kind) {
+    case MetricKind::Euclidean2D: return f(Euclidean2D());
+    case MetricKind::Manhattan:   return f(Manhattan());
+    case MetricKind::Chebyshev:   return f(Chebyshev());
+    case MetricKind::TravelTime:  return f(TravelTime(opt.machine));
+    case MetricKind::Retract:     return f(Retract(opt.clearance));
+    case MetricKind::RetractTime: return f(RetractTime(opt.machine, opt.clearance));
+    case MetricKind::Euclidean3D: break;
+    }
+    return f(Euclidean3D());
+}
+
+// Policy name, as accepted by parseMetric()
+inline const char* metricName(MetricKind kind) {
+    MetricOptions opt;
+    opt.kind = kind;
+    return withMetric(opt, [](auto m) { return decltype(m)::name; });
+}
+
+// Parse a metric name; false if it is unknown
+inline bool parseMetric(const char* s, MetricKind& kind) {
+    for (MetricKind k : {MetricKind::Euclidean3D, MetricKind::Euclidean2D, MetricKind::Manhattan,
+                         MetricKind::Chebyshev, MetricKind::TravelTime, MetricKind::Retract,
+                         MetricKind::RetractTime}) {
+        if (std::string(s) == metricName(k)) {
+            kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Copy of pts with every coordinate multiplied by the weight of its axis
+inline PointSet weightedPoints(const PointSet& pts, const double w[3]) {
+    PointSet out = pts;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        out.x[i] *= w[0];
+        out.y[i] *= w[1];
+        out.z[i] *= w[2];
+    }
+    return out;
+}
+
+#endif
@@ -0,0 +1,131 @@
+// ============================================================================
+// File: MultiStart.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Parallel multi-start optimization (see MultiStart.h).
+// ============================================================================
+
+#include "MultiStart.h"
+#include "PathOptimizer.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <limits>
+#include <random>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Rotate a greedy walk so that it starts at ends.start.  The walk is closed
+// into a cycle and the longer of the two cycle edges at the start is dropped
+// (either one for a closed path, which keeps every edge), tool changes
+// included.  A fixed end point, last in the walk, is taken out first and put
+// back at the end.
+//------------------------------------------------------------------------------
+template <class Metric>
+static vector<int> rotateToStart(const PointSet& pts, vector<int> walk, const PathEnds& ends,
+                                 const PathConstraints& cons, const Metric& metric) {
+    int s = ends.start;
+    if (ends.end >= 0) walk.pop_back();
+    size_t n = walk.size();
+    size_t k = 0;
+    while (walk[k] != s) ++k;
+
+    vector<int> out;
+    out.reserve(n + 1);
+    int before = walk[(k + n - 1) % n];
+    int after = walk[(k + 1) % n];
+    double costBefore = moveCost(metric, pts, before, s) + cons.changeCost(before, s);
+    double costAfter = moveCost(metric, pts, s, after) + cons.changeCost(s, after);
+    if (k == 0 || costBefore >= costAfter) {
+        for (size_t j = 0; j < n; ++j) out.push_back(walk[(k + j) % n]);       // drop (before, s)
+    } else {
+        for (size_t j = 0; j < n; ++j) out.push_back(walk[(k + n - j) % n]);   // drop (s, after)
+    }
+    if (ends.end >= 0) out.push_back(ends.end);
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// Multi-start driver
+//------------------------------------------------------------------------------
+template <class Metric>
+MultiStartResult multiStartOptimize(const PointSet& pts, const NeighborLists& nbr,
+                                    const ImproveOptions& improve, const MultiStartOptions& opt,
+                                    const PathEnds& ends, const PathConstraints& cons,
+                                    const Deadline& deadline, const Metric& metric) {
+    auto t0 = chrono::steady_clock::now();
+    int n = static_cast<int>(pts.size());
+    int starts = max(1, opt.starts);
+
+    struct Slot {
+        vector<int> order;
+        double length = numeric_limits<double>::max();
+        int startPoint = -1;
+        bool done = false;
+        bool timedOut = false;
+    };
+    vector<Slot> slots(starts);
+
+    ThreadPool pool(opt.threads);
+    for (int i = 0; i < starts; ++i) {
+        pool.submit([&, i] {
+            // Each task polls its own copy of the deadline
+            Deadline dl = deadline;
+            if (i > 0 && dl.expiredNow()) return;
+
+            Slot& s = slots[i];
+            PathEnds walkEnds = ends;
+            long firstMove = -1;
+            if (i > 0) {
+                seed_seq seq{opt.seed, static_cast<unsigned>(i)};
+                mt19937 rng(seq);
+                if (cons.empty()) {
+                    walkEnds.start = static_cast<int>(rng() % n);
+                    if (walkEnds.start == ends.end) walkEnds.start = ends.start;
+                } else {
+                    firstMove = static_cast<long>(rng() % n);
+                }
+            }
+            s.startPoint = walkEnds.start;
+
+            s.order = rotateToStart(pts, optimizePathKdTree(pts, walkEnds, cons, metric, firstMove), ends,
+                                    cons, metric);
+
+            ImproveOptions local = improve;
+            local.lk.seed = improve.lk.seed + static_cast<unsigned>(i);
+            s.timedOut = improvePath(pts, s.order, nbr, local, ends, cons, dl, metric);
+
+            s.length = computePathLength(pts, s.order, metric, ends.closed) +
+                       cons.toolChangesCost(s.order, ends.closed);
+            s.done = true;
+        });
+    }
+    pool.wait();
+
+    MultiStartResult res;
+    res.threads = pool.size();
+    for (int i = 0; i < starts; ++i) {
+        if (slots[i].timedOut || !slots[i].done) res.timedOut = true;
+        if (!slots[i].done) continue;
+        ++res.completed;
+        if (res.order.empty() || slots[i].length < res.length) {
+            res.order.swap(slots[i].order);
+            res.length = slots[i].length;
+            res.bestStart = i;
+            res.startPoint = slots[i].startPoint;
+        }
+    }
+    res.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+#define INSTANTIATE(M)                                                                         \
+    template MultiStartResult multiStartOptimize<M>(const PointSet&, const NeighborLists&,     \
+                                                    const ImproveOptions&,                     \
+                                                    const MultiStartOptions&, const PathEnds&, \
+                                                    const PathConstraints&, const Deadline&,   \
+                                                    const M&);
+PATHOPT_FOR_EACH_METRIC(INSTANTIATE)
@@ -0,0 +1,60 @@
+// ============================================================================
+// File: MultiStart.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Parallel multi-start optimization.  Each start runs the greedy
+//   construction from a different point, turns the result into a path that
+//   begins at the start point (closing it into a cycle and cutting the
+//   longer of the two edges at the start), and applies the improvement
+//   stages; a fixed end point stays last.  The starts are run as tasks on a
+//   work-stealing ThreadPool and the shortest path is kept.
+//
+//   Start 0 is the plain single-start run from the start point; start i > 0
+//   uses a start point and LK seed derived only from (seed, i).  Visiting-
+//   order constraints rule out the rotation, so with them every start walks
+//   from the start point and start i > 0 instead makes its first move to a
+//   point, among those allowed next, drawn from (seed, i).  Ties go to
+//   the lowest start index, so the result depends on the seed and the number
+//   of starts but not on the number of threads or on scheduling.
+// ============================================================================
+
+#ifndef MULTISTART_H
+#define MULTISTART_H
+
+#include <vector>
+
+#include "PointSet.h"
+#include "Metric.h"
+#include "LocalSearch.h"
+#include "Deadline.h"
+#include "PathEnds.h"
+#include "PathConstraints.h"
+
+struct MultiStartOptions {
+    int starts = 1;
+    int threads = 0;        // 0 = one per hardware core
+    unsigned seed = 1;
+};
+
+struct MultiStartResult {
+    std::vector<int> order;
+    double length = 0.0;    // tool changes included
+    int bestStart = 0;      // index of the winning start
+    int startPoint = 0;     // point the winning greedy walk started from
+    int completed = 0;      // starts run before the deadline
+    bool timedOut = false;  // a start was skipped or cut short by the deadline
+    int threads = 0;
+    double seconds = 0.0;
+};
+
+template <class Metric = Euclidean3D>
+MultiStartResult multiStartOptimize(const PointSet& pts, const NeighborLists& nbr,
+                                    const ImproveOptions& improve, const MultiStartOptions& opt,
+                                    const PathEnds& ends = PathEnds(),
+                                    const PathConstraints& cons = PathConstraints(),
+                                    const Deadline& deadline = Deadline(),
+                                    const Metric& metric = Metric());
+
+#endif
@@ -12,11 +12,13 @@
 //
 //   The optimization is based on a simple greedy nearest-neighbor heuristic,
 //   which provides a fast but non-global approximation to the optimal
-//   Traveling Salesman path.  The resulting order is useful for minimizing
-//   travel time or repositioning movements in scanning or machining systems.
+//   Traveling Salesman path, optionally refined by 2-opt, Or-opt or
+//   Lin-Kernighan local search.  The resulting order is useful for
+//   minimizing travel time or repositioning movements in scanning or
+//   machining systems.
 //
 //   The program outputs:
-//     • Console summary of the original and optimized path lengths
+//     • Console summary of the original, greedy and optimized path lengths
 //     • A reordered CSV file containing the optimized sequence
 //     • Three interactive ROOT canvases:
 //         1. Original path (red)
@@ -24,28 +26,164 @@
 //         3. Both paths superimposed for visual comparison
 //
 // Usage:
-//   ./OptimizePath input.csv output.csv
+//   ./OptimizePath [--construct greedy|hilbert|morton]
+//                  [--nn kdtree|brute] [--ties index|scan]
+//                  [--optimizer none|2opt|lk] [--kicks N] [--max-flip N]
+//                  [--oropt] [--neighbors K] [--time-limit sec]
+//                  [--starts N] [--threads T] [--seed S]
+//                  [--metric euclid3d|euclid2d|manhattan|chebyshev|time|
+//                            retract|retract-time]
+//                  [--weights wx,wy,wz] [--machine config] [--clearance Z]
+//                  [--start label] [--end label] [--closed]
+//                  [--constraints file] [--tool-change C] [--machines k]
+//                  [--reader mmap|common] [--stats] [--write-binary]
+//                  [--write-order text|binary] [--batch] input.csv output.csv
+//
+//   --construct     initial path: the greedy nearest-neighbor walk
+//                   (default), or the order of a Hilbert or Morton
+//                   space-filling curve through the points (radix-sorted
+//                   64-bit keys: milliseconds on millions of points, for
+//                   quick previews or as a seed for the improvement
+//                   stages).  The greedy walk is kept with --constraints or
+//                   --tool-change, and for the walks of multi-start
+//   --nn            nearest-neighbor engine: k-d tree (default, about
+//                   O(n log n)) or the original brute-force scan (O(n^2));
+//                   both give the same order
+//   --ties          how the brute-force scan breaks equal distances: lowest
+//                   point index (default, matches the k-d tree) or first
+//                   found in its swap-remove unvisited array
+//   --optimizer     improvement stage run after the greedy construction:
+//                   none, 2opt (default; edge exchange limited to each
+//                   point's nearest neighbours, with don't-look bits) or lk
+//                   (variable-depth Lin-Kernighan, slower but better)
+//   --kicks N       with lk: number of double-bridge kicks of iterated LK
+//                   (default 0); each is kept only if the path gets shorter
+//   --max-flip N    with lk: skip flips that reverse more than N points
+//                   (default 0 = no limit); trades quality for speed on
+//                   very large inputs
+//   --oropt         add an Or-opt stage that moves segments of 1-3 points
+//                   to better places; prints the gain and time of each pass
+//   --neighbors K   candidate list size for the improvement stages (default 10)
+//   --time-limit s  anytime mode: the greedy order is always produced, then
+//                   the improvement stages run in turn until 's' seconds
+//                   after program start and the best order so far is
+//                   written.  With lk and no --kicks, iterated LK keeps
+//                   kicking until the deadline.
+//   --starts N      multi-start: run the greedy construction from N start
+//                   points (point 0 plus N-1 random ones) followed by the
+//                   improvement stages, in parallel, and keep the best path
+//   --threads T     worker threads for multi-start, for the brute-force
+//                   scan and for parsing the input (default: all cores);
+//                   neither the brute-force order nor the point order
+//                   depends on T
+//   --seed S        random seed for start points and LK kicks (default 1);
+//                   results depend on the seed and N, not on T
+//   --metric        distance minimized by every stage: euclid3d (default),
+//                   euclid2d (XY plane, Z ignored), manhattan (sum of the
+//                   axis distances), chebyshev (largest axis distance),
+//                   time (estimated move time on the --machine model),
+//                   retract (probe moves through the --clearance plane:
+//                   retract, XY move, approach) or retract-time (the time
+//                   of those moves on the --machine model)
+//   --weights w     per-axis weights multiplying the X, Y and Z differences
+//                   before the metric is applied (default 1,1,1), e.g. for
+//                   axes of different speed; the output keeps the original
+//                   coordinates
+//   --machine file  machine config with per-axis velocity, acceleration and
+//                   settle time (format in MachineModel.h).  Selects the
+//                   time metric unless --metric is given, so every stage
+//                   minimizes the estimated cycle time; the initial and
+//                   optimized paths are reported both in seconds and in
+//                   length
+//   --clearance Z   Z of the clearance plane: every move retracts to it,
+//                   moves in XY and descends onto the next point.  Selects
+//                   the retract metric, or retract-time with --machine,
+//                   unless --metric is given
+//   --start label   first point of the path (default: the first point of
+//                   the input that the constraints allow first)
+//   --end label     last point of the path (default: wherever the path
+//                   ends up)
+//   --closed        closed tour: return to the start after the last point.
+//                   The return move counts in every reported length; the
+//                   output lists each point once
+//   --constraints   visiting-order constraints: ordered groups of points and
+//                   'before' pairs, named by label (format in
+//                   PathConstraints.h).  Every stage keeps the order
+//                   feasible; --nn is ignored (the k-d tree walk is used)
+//   --tool-change C cost of one tool (probe tip) change, in the units of the
+//                   metric (seconds with a time metric).  Needs the tool
+//                   column in the input; every stage then minimizes travel
+//                   plus tool changes, and the number of changes and the
+//                   time saved are reported.  --nn is ignored
+//   --machines k    split the points among k machines (or probe heads)
+//                   working at once, balancing their paths so that the
+//                   longest is as short as possible; the paths are
+//                   optimized in parallel and machine m is written to
+//                   output_m.csv (e.g. scan_opt_1.csv for scan_opt.csv).
+//                   Each path starts at its own first point, so --start,
+//                   --end, --closed and --constraints cannot be used
+//   --reader        input parser: mmap (default; memory-mapped, from_chars,
+//                   no per-point allocation) or common (readPoints() from
+//                   ../common)
+//   --write-binary  write the output as a binary point file (see PathIO.h)
+//                   instead of CSV; the mmap reader loads such files as
+//                   input without parsing, so a large scan can be converted
+//                   once (e.g. with --optimizer none) and re-optimized fast
+//   --write-order   write only the visiting order, as 0-based indices of the
+//                   input points: text (one per line) or binary (raw uint32
+//                   array, native byte order)
+//   --stats         print the size of the input, the time and throughput of
+//                   reading and parsing it, and the time to write the output
+//   --batch         headless run: exit as soon as the CSV is written, without
+//                   loading ROOT or opening any canvas
 //
 // Input format (CSV or space-separated):
 //   label,X,Y,Z
 //   or
+//   label,tool,X,Y,Z    (tool of the point: any name, e.g. the probe tip)
+//   or
 //   X,Y,Z               (label optional)
+//   or a binary point file written with --write-binary (mmap reader only)
 //
 // Output format:
-//   label,X,Y,Z         (in optimized order)
+//   label,X,Y,Z         (in optimized order, coordinates written exactly:
+//                       shortest form that reads back to the same double;
+//                       label,tool,X,Y,Z if the input had tools),
+//                       or binary with --write-binary,
+//                       or just the order with --write-order
 //
 // Dependencies:
-//   • ROOT framework (for visualization)
-//   • Points.h / Points.cpp from ../common (defines Point structure and I/O)
+//   • ROOT framework (for visualization only: PathViewer.h / PathViewer.cpp,
+//     built as a plugin that is loaded with dlopen() unless --batch is given)
+//   • libpathopt (PathOpt.h): the ROOT-free optimizer core, i.e.
+//       - Points.h / Points.cpp from ../common (Point structure and input)
+//       - PathIO.h / PathIO.cpp, MappedFile.h / MappedFile.cpp (fast input
+//         and output)
+//       - PathOptimizer.h / PathOptimizer.cpp (path length and greedy
+//         construction), DistanceKernels.h / .cpp, PointSet.h, Metric.h,
+//         MachineModel.h / MachineModel.cpp (travel-time metric)
+//       - KdTree.h / KdTree.cpp (spatial index for the nearest-neighbor search)
+//       - SpaceFillingCurve.h / SpaceFillingCurve.cpp (curve construction)
+//       - LocalSearch.h / LocalSearch.cpp, LinKernighan.cpp, Tour.h
+//         (improvement stages)
+//       - MultiStart.h / MultiStart.cpp, ThreadPool.h / ThreadPool.cpp
+//         (parallel multi-start and machine paths)
 //
 // Compilation:
-//   Handled by the provided Makefile using root-config for automatic linking.
+//   Handled by the provided Makefile.  "make" builds libpathopt and this
+//   program without ROOT; "make viewer" builds the ROOT viewer plugin and the
+//   standalone ViewPath viewer using root-config.
 //   Example:
-//       make clean && make
+//       make clean && make && make viewer
 //
 // Notes:
-//   - The algorithm is deterministic and assumes the first point as the start.
-//   - Path lengths are computed in 3D Euclidean space.
+//   - The algorithm is deterministic and starts at the first point (the
+//     first one the constraints allow) unless --start names another one.
+//     Equal distances are resolved towards the lowest point index.
+//   - Path lengths are computed in the selected metric (3D Euclidean by
+//     default), including the weights; with the time metric they are
+//     estimated cycle times in seconds.  With --tool-change they also
+//     include the cost of the tool changes.
 //   - The program is intended for exploratory analysis, visualization, and
 //     workflow optimization, not for rigorous combinatorial minimization.
 //
@@ -53,195 +191,507 @@
 
 
 #include <iostream>
-#include <fstream>
+#include <iomanip>
 #include <vector>
 #include <string>
 #include <cmath>
 #include <algorithm>
 #include <numeric>   // for std::iota
 #include <limits>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <dlfcn.h>
 
-#include "Points.h"  // from ../common
-
-#include "TApplication.h"
-#include "TCanvas.h"
-#include "TGraph.h"
-#include "TLegend.h"
-#include "TStyle.h"
+#include "PathOpt.h"
+#include "PathViewer.h"
 
 using namespace std;
 
 //------------------------------------------------------------------------------
-// Compute total length of a path given point order
+// Output file of machine m (1-based) with --machines: scan_opt.csv ->
+// scan_opt_1.csv
 //------------------------------------------------------------------------------
-double computePathLength(const vector<Point>& pts, const vector<int>& order) {
-    double total = 0.0;
-    for (size_t i = 1; i < order.size(); ++i) {
-        double dx = pts[order[i]].coords[0] - pts[order[i - 1]].coords[0];
-        double dy = pts[order[i]].coords[1] - pts[order[i - 1]].coords[1];
-        double dz = pts[order[i]].coords[2] - pts[order[i - 1]].coords[2];
-        total += sqrt(dx * dx + dy * dy + dz * dz);
-    }
-    return total;
+static string machineOutputFile(const string& outFile, int m) {
+    size_t slash = outFile.rfind('/');
+    size_t dot = outFile.rfind('.');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) dot = outFile.size();
+    return outFile.substr(0, dot) + "_" + to_string(m) + outFile.substr(dot);
 }
 
 //------------------------------------------------------------------------------
-// Simple greedy nearest-neighbor path optimization
+// Interactive display through the ROOT viewer plugin
 //------------------------------------------------------------------------------
-vector<int> optimizePath(const vector<Point>& pts) {
-    size_t n = pts.size();
-    vector<int> remaining(n);
-    iota(remaining.begin(), remaining.end(), 0);
-
-    vector<int> order;
-    order.reserve(n);
-
-    int current = 0;
-    order.push_back(current);
-    remaining.erase(remaining.begin());
-
-    while (!remaining.empty()) {
-        double bestDist = numeric_limits<double>::max();
-        size_t bestIdx = 0;
-        for (size_t i = 0; i < remaining.size(); ++i) {
-            double dx = pts[remaining[i]].coords[0] - pts[current].coords[0];
-            double dy = pts[remaining[i]].coords[1] - pts[current].coords[1];
-            double dz = pts[remaining[i]].coords[2] - pts[current].coords[2];
-            double d = sqrt(dx * dx + dy * dy + dz * dz);
-            if (d < bestDist) {
-                bestDist = d;
-                bestIdx = i;
-            }
-        }
-        current = remaining[bestIdx];
-        order.push_back(current);
-        remaining.erase(remaining.begin() + bestIdx);
+static int showPaths(int argc, char** argv, const PointSet& coords, const vector<int>& origOrder,
+                     const vector<int>& order) {
+    string viewerPath = PATHVIEWER_LIBRARY;
+    string self = argv[0];
+    size_t slash = self.rfind('/');
+    if (slash != string::npos) viewerPath = self.substr(0, slash + 1) + viewerPath;
+
+    void* viewer = dlopen(viewerPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    ShowPathsFn show = viewer ? reinterpret_cast<ShowPathsFn>(dlsym(viewer, PATHVIEWER_SYMBOL)) : nullptr;
+    if (!show) {
+        cerr << "Error: cannot load the ROOT viewer (" << dlerror() << "); use --batch to skip it" << endl;
+        return 1;
     }
-
-    return order;
-}
-
-//------------------------------------------------------------------------------
-// Write points in specified order to CSV
-//------------------------------------------------------------------------------
-void writeReorderedPoints(const string& outFile, const vector<Point>& pts, const vector<int>& order) {
-    ofstream out(outFile);
-    if (!out.is_open()) {
-        cerr << "Error: cannot open output file " << outFile << endl;
-        exit(1);
-    }
-    for (int idx : order) {
-        out << pts[idx].label << ","
-            << pts[idx].coords[0] << ","
-            << pts[idx].coords[1] << ","
-            << pts[idx].coords[2] << "\n";
-    }
-    cout << "Wrote reordered points to " << outFile << endl;
+    return show(&argc, argv, coords.x.data(), coords.y.data(),
+                origOrder.data(), origOrder.size(), order.data(), order.size());
 }
 
 //------------------------------------------------------------------------------
 // Main
 //------------------------------------------------------------------------------
 int main(int argc, char** argv) {
-    if (argc < 3) {
-        cerr << "Usage: " << argv[0] << " input.csv output.csv" << endl;
-        return 1;
+    auto startTime = Deadline::Clock::now();
+
+    string inFile, outFile;
+    PathOptOptions opt;
+    double timeLimit = 0.0;   // seconds, 0 = none
+    bool batch = false;
+    bool fastReader = true;
+    bool stats = false;
+    PointFormat outFormat = PointFormat::Csv;
+    string machineFile;
+    bool metricGiven = false;
+    bool haveClearance = false;
+    string startLabel, endLabel;
+    string constraintFile;
+    double toolChange = -1.0;   // cost of a tool change, < 0 = ignore tools
+    int machines = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--construct" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "greedy")       opt.curve = Curve::None;
+            else if (val == "hilbert") opt.curve = Curve::Hilbert;
+            else if (val == "morton")  opt.curve = Curve::Morton;
+            else {
+                cerr << "Error: unknown --construct '" << val << "' (use greedy, hilbert or morton)" << endl;
+                return 1;
+            }
+        } else if (arg == "--nn" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "kdtree")     opt.engine = NNEngine::KdTree;
+            else if (val == "brute") opt.engine = NNEngine::BruteForce;
+            else {
+                cerr << "Error: unknown --nn engine '" << val << "' (use kdtree or brute)" << endl;
+                return 1;
+            }
+        } else if (arg == "--ties" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "index")     opt.lowestIndexTies = true;
+            else if (val == "scan") opt.lowestIndexTies = false;
+            else {
+                cerr << "Error: unknown --ties mode '" << val << "' (use index or scan)" << endl;
+                return 1;
+            }
+        } else if (arg == "--optimizer" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "none")      opt.improve.improver = Improver::None;
+            else if (val == "2opt") opt.improve.improver = Improver::TwoOpt;
+            else if (val == "lk")   opt.improve.improver = Improver::LinKernighan;
+            else {
+                cerr << "Error: unknown --optimizer '" << val << "' (use none, 2opt or lk)" << endl;
+                return 1;
+            }
+        } else if (arg == "--kicks" && i + 1 < argc) {
+            opt.improve.lk.kicks = atol(argv[++i]);
+        } else if (arg == "--max-flip" && i + 1 < argc) {
+            opt.improve.lk.maxFlip = atoi(argv[++i]);
+        } else if (arg == "--starts" && i + 1 < argc) {
+            opt.multi.starts = atoi(argv[++i]);
+            if (opt.multi.starts < 1) {
+                cerr << "Error: --starts must be at least 1" << endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opt.multi.threads = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            opt.multi.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+            opt.improve.lk.seed = opt.multi.seed;
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            timeLimit = atof(argv[++i]);
+            if (timeLimit <= 0.0) {
+                cerr << "Error: --time-limit must be a positive number of seconds" << endl;
+                return 1;
+            }
+        } else if (arg == "--metric" && i + 1 < argc) {
+            string val = argv[++i];
+            if (!parseMetric(val.c_str(), opt.metric.kind)) {
+                cerr << "Error: unknown --metric '" << val
+                     << "' (use euclid3d, euclid2d, manhattan, chebyshev, time, retract or retract-time)"
+                     << endl;
+                return 1;
+            }
+            metricGiven = true;
+        } else if (arg == "--machine" && i + 1 < argc) {
+            machineFile = argv[++i];
+        } else if (arg == "--clearance" && i + 1 < argc) {
+            char* end = nullptr;
+            opt.metric.clearance = strtod(argv[++i], &end);
+            if (end == argv[i] || *end) {
+                cerr << "Error: --clearance must be a Z coordinate" << endl;
+                return 1;
+            }
+            haveClearance = true;
+        } else if (arg == "--weights" && i + 1 < argc) {
+            string val = argv[++i];
+            double* w = opt.metric.weights;
+            char tail = 0;
+            if (sscanf(val.c_str(), "%lf,%lf,%lf%c", &w[0], &w[1], &w[2], &tail) != 3 ||
+                !(w[0] > 0.0 && w[1] > 0.0 && w[2] > 0.0)) {
+                cerr << "Error: --weights must be three positive numbers, e.g. 1,1,0.5" << endl;
+                return 1;
+            }
+        } else if (arg == "--start" && i + 1 < argc) {
+            startLabel = argv[++i];
+        } else if (arg == "--end" && i + 1 < argc) {
+            endLabel = argv[++i];
+        } else if (arg == "--closed") {
+            opt.ends.closed = true;
+        } else if (arg == "--constraints" && i + 1 < argc) {
+            constraintFile = argv[++i];
+        } else if (arg == "--tool-change" && i + 1 < argc) {
+            char* end = nullptr;
+            toolChange = strtod(argv[++i], &end);
+            if (end == argv[i] || *end || !(toolChange >= 0.0)) {
+                cerr << "Error: --tool-change must be a cost of zero or more" << endl;
+                return 1;
+            }
+        } else if (arg == "--machines" && i + 1 < argc) {
+            machines = atoi(argv[++i]);
+            if (machines < 1) {
+                cerr << "Error: --machines must be at least 1" << endl;
+                return 1;
+            }
+        } else if (arg == "--reader" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "mmap")        fastReader = true;
+            else if (val == "common") fastReader = false;
+            else {
+                cerr << "Error: unknown --reader '" << val << "' (use mmap or common)" << endl;
+                return 1;
+            }
+        } else if (arg == "--write-binary") {
+            outFormat = PointFormat::Binary;
+        } else if (arg == "--write-order" && i + 1 < argc) {
+            string val = argv[++i];
+            if (val == "text")        outFormat = PointFormat::OrderText;
+            else if (val == "binary") outFormat = PointFormat::OrderBinary;
+            else {
+                cerr << "Error: unknown --write-order '" << val << "' (use text or binary)" << endl;
+                return 1;
+            }
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--oropt") {
+            opt.improve.orOpt = true;
+        } else if (arg == "--neighbors" && i + 1 < argc) {
+            opt.neighbors = atoi(argv[++i]);
+            if (opt.neighbors < 1) {
+                cerr << "Error: --neighbors must be at least 1" << endl;
+                return 1;
+            }
+        } else if (inFile.empty()) {
+            inFile = arg;
+        } else if (outFile.empty()) {
+            outFile = arg;
+        }
     }
 
-    string inFile = argv[1];
-    string outFile = argv[2];
+    if (inFile.empty() || outFile.empty()) {
+        cerr << "Usage: " << argv[0] << " [--construct greedy|hilbert|morton]"
+             << " [--nn kdtree|brute] [--ties index|scan]"
+             << " [--optimizer none|2opt|lk] [--kicks N] [--max-flip N] [--oropt] [--neighbors K]"
+             << " [--time-limit sec] [--starts N] [--threads T] [--seed S]"
+             << " [--metric euclid3d|euclid2d|manhattan|chebyshev|time|retract|retract-time]"
+             << " [--weights wx,wy,wz] [--machine config] [--clearance Z]"
+             << " [--start label] [--end label] [--closed] [--constraints file] [--tool-change C]"
+             << " [--machines k]"
+             << " [--reader mmap|common] [--stats] [--write-binary] [--write-order text|binary] [--batch]"
+             << " input.csv output.csv" << endl;
+        return 1;
+    }
 
-    // Initialize ROOT GUI
-    TApplication app("OptimizePathApp", &argc, argv);
+    // --machine and --clearance pick the metric unless it was given
+    bool haveMachine = !machineFile.empty();
+    if (haveMachine) {
+        string error;
+        if (!loadMachineModel(machineFile, opt.metric.machine, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+    }
+    if (!metricGiven && haveClearance)
+        opt.metric.kind = haveMachine ? MetricKind::RetractTime : MetricKind::Retract;
+    else if (!metricGiven && haveMachine)
+        opt.metric.kind = MetricKind::TravelTime;
+    MetricKind kind = opt.metric.kind;
+    bool timed = kind == MetricKind::TravelTime || kind == MetricKind::RetractTime;
+    if (timed && !haveMachine) {
+        cerr << "Error: --metric " << metricName(kind) << " needs a --machine config" << endl;
+        return 1;
+    }
+    if ((kind == MetricKind::Retract || kind == MetricKind::RetractTime) && !haveClearance) {
+        cerr << "Error: --metric " << metricName(kind) << " needs --clearance Z" << endl;
+        return 1;
+    }
 
-    // Read points
-    vector<Point> pts = readPoints(inFile, 3);
-    if (pts.empty()) {
+    // Read points: coordinates for the optimizer, labels kept for output
+    PointCloud cloud;
+    if (fastReader) {
+        string error;
+        LoadStats ls;
+        if (!loadPoints(inFile, cloud, error, opt.multi.threads, &ls)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if (stats) {
+            double mb = ls.bytes / 1e6;
+            cout << "Read " << ls.points << " points, " << fixed << setprecision(1) << mb << " MB: map "
+                 << setprecision(3) << ls.mapSeconds << " s, ";
+            if (ls.chunks == 0)
+                cout << "binary load " << ls.parseSeconds << " s, ";
+            else
+                cout << "parse " << ls.parseSeconds << " s on " << ls.threads << " threads ("
+                     << ls.chunks << " chunks), ";
+            cout << setprecision(0) << mb / max(ls.parseSeconds, 1e-9) << " MB/s"
+                 << defaultfloat << setprecision(6) << endl;
+        }
+    } else {
+        auto t0 = Deadline::Clock::now();
+        cloud = pointCloudFromPoints(readPoints(inFile, 3));
+        if (stats) {
+            cout << "Read " << cloud.size() << " points with readPoints(): " << fixed << setprecision(3)
+                 << chrono::duration<double>(Deadline::Clock::now() - t0).count() << " s"
+                 << defaultfloat << setprecision(6) << endl;
+        }
+    }
+    if (cloud.size() == 0) {
         cerr << "Error: no points read from " << inFile << endl;
         return 1;
     }
+    const PointSet& coords = cloud.coords;
+
+    // Path ends and constraints, naming points by label
+    const PathConstraints& cons = opt.constraints;
+    if (!startLabel.empty() || !endLabel.empty() || !constraintFile.empty()) {
+        LabelIndex labels(cloud);
+        auto lookup = [&](const string& label, int& index) {
+            if (label.empty()) return true;
+            index = labels.find(label);
+            if (index < 0) cerr << "Error: no point labeled '" << label << "' in " << inFile << endl;
+            return index >= 0;
+        };
+        if (!lookup(startLabel, opt.ends.start) || !lookup(endLabel, opt.ends.end)) return 1;
+
+        string error;
+        if (!constraintFile.empty() &&
+            !loadConstraints(constraintFile, labels, static_cast<int>(cloud.size()), opt.constraints, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+    }
+    if (startLabel.empty() && !cons.empty()) opt.ends.start = cons.firstStart();
+    if (!cons.canStart(opt.ends.start)) {
+        cerr << "Error: '" << cloud.labels[opt.ends.start] << "' cannot come first: it is not in the"
+             << " first group or has to come after another point" << endl;
+        return 1;
+    }
+    if (opt.ends.end >= 0 && !cons.canEnd(opt.ends.end)) {
+        cerr << "Error: '" << cloud.labels[opt.ends.end] << "' cannot come last: it is not in the"
+             << " last group or has to come before another point" << endl;
+        return 1;
+    }
+
+    // Tools, numbered in order of first appearance
+    if (toolChange >= 0.0) {
+        if (cloud.tools.empty()) {
+            cerr << "Error: --tool-change needs a tool column (label,tool,X,Y,Z) in " << inFile << endl;
+            return 1;
+        }
+        unordered_map<string_view, int> ids;
+        vector<int> tool(cloud.size());
+        for (size_t i = 0; i < cloud.size(); ++i)
+            tool[i] = ids.emplace(cloud.tools[i], static_cast<int>(ids.size())).first->second;
+        opt.constraints.setTools(tool, toolChange);
+    }
+    if (opt.ends.closed && opt.ends.end >= 0) {
+        cerr << "Error: a closed path ends at its start; --end cannot be used with --closed" << endl;
+        return 1;
+    }
+    if (opt.ends.end == opt.ends.start) {
+        cerr << "Error: --end names the start point (use --closed for a round trip)" << endl;
+        return 1;
+    }
+
+    if (machines > 1) {
+        if (!startLabel.empty() || !endLabel.empty() || opt.ends.closed || !cons.empty()) {
+            cerr << "Error: --machines cannot be combined with --start, --end, --closed or --constraints" << endl;
+            return 1;
+        }
+        if (static_cast<size_t>(machines) > cloud.size()) {
+            cerr << "Error: --machines " << machines << " is more than the " << cloud.size() << " points" << endl;
+            return 1;
+        }
+    }
 
-    // Compute initial path
-    vector<int> origOrder(pts.size());
+    // Greedy construction, then local-search improvement within the time
+    // budget if one was given.  The greedy order is always completed first.
+    // With several machines, the same for each machine path.
+    Deadline deadline = timeLimit > 0.0 ? Deadline(timeLimit, startTime) : Deadline();
+    PathOptReport rep;
+    PartitionReport part;
+    if (machines > 1) part = optimizePartition(coords, machines, opt, deadline);
+    else              rep = optimizeOrder(coords, opt, deadline);
+
+    if (opt.metric.kind != MetricKind::Euclidean3D || opt.metric.weighted() || haveMachine) {
+        cout << "Metric: " << metricName(opt.metric.kind);
+        if (opt.metric.weighted())
+            cout << ", weights " << opt.metric.weights[0] << "," << opt.metric.weights[1] << ","
+                 << opt.metric.weights[2];
+        if (haveMachine) cout << ", machine " << machineFile;
+        if (haveClearance) cout << ", clearance Z = " << opt.metric.clearance;
+        cout << endl;
+    }
+    if (!cons.empty()) {
+        cout << "Constraints: " << cons.groupCount() << " groups, " << cons.pairCount()
+             << " precedence pairs (" << constraintFile << "), start at '"
+             << cloud.labels[opt.ends.start] << "'" << endl;
+    }
+
+    if (toolChange >= 0.0) {
+        cout << "Tools: " << cons.toolCount() << " (" << toolChange << (timed ? " s" : "")
+             << " per change)" << endl;
+    }
+
+    // With a time metric the stage results are seconds, tool changes
+    // included.  Given a machine, the initial and final paths are also shown
+    // in the other unit: the length of the same moves, or their estimated
+    // time, next to the number of tool changes if there are tools.
+    string cost = timed ? " cycle time = " : cons.hasTools() ? " path cost = " : " path length = ";
+    string unit = timed ? " s" : "";
+    MetricOptions other = opt.metric;
+    switch (kind) {
+    case MetricKind::TravelTime:  other.kind = MetricKind::Euclidean3D; break;
+    case MetricKind::RetractTime: other.kind = MetricKind::Retract; break;
+    case MetricKind::Retract:     other.kind = MetricKind::RetractTime; break;
+    default:                      other.kind = MetricKind::TravelTime; break;
+    }
+    auto details = [&](const vector<int>& order, long toolChanges) -> string {
+        ostringstream os;
+        if (cons.hasTools()) os << toolChanges << " tool changes";
+        if (haveMachine) {
+            double v = withMetric(other, [&](auto m) { return computePathLength(coords, order, m, opt.ends.closed); });
+            if (cons.hasTools()) os << ", ";
+            if (timed) os << "path length " << v;
+            else       os << "estimated " << v << " s";
+        }
+        string text = os.str();
+        return text.empty() ? text : " (" + text + ")";
+    };
+    vector<int> origOrder(coords.size());
     iota(origOrder.begin(), origOrder.end(), 0);
-    double origLen = computePathLength(pts, origOrder);
 
-    // Optimize
-    vector<int> optOrder = optimizePath(pts);
-    double optLen = computePathLength(pts, optOrder);
+    // Several machines: one path and one output file each
+    if (machines > 1) {
+        cout << "Machines: " << machines << ", single" << cost << part.singleLength << unit << " ("
+             << part.rounds << (part.rounds == 1 ? " round, " : " rounds, ") << fixed << setprecision(3) << part.seconds << " s)"
+             << defaultfloat << setprecision(6) << endl;
+        vector<int> chained;
+        for (int m = 0; m < machines; ++m) {
+            const PathOptReport& mr = part.machines[m];
+            string file = machineOutputFile(outFile, m + 1);
+            if (!writeReorderedPoints(file, cloud, mr.order, outFormat)) {
+                cerr << "Error: cannot write output file " << file << endl;
+                return 1;
+            }
+            cout << "Machine " << m + 1 << ": " << mr.order.size() << " points," << cost << mr.length << unit
+                 << details(mr.order, mr.toolChanges) << ", written to " << file << endl;
+            chained.insert(chained.end(), mr.order.begin(), mr.order.end());
+        }
+        cout << "Longest" << cost << part.longest << unit << endl;
+        if (part.timedOut) {
+            cout << "Time limit of " << timeLimit << " s reached after "
+                 << chrono::duration<double>(Deadline::Clock::now() - startTime).count()
+                 << " s; best paths so far are used" << endl;
+        }
+        if (batch) return 0;
+        return showPaths(argc, argv, coords, origOrder, chained);
+    }
 
-    cout << "Initial path length = " << origLen << endl;
-    cout << "Optimized path length = " << optLen << endl;
+    cout << "Initial" << cost << rep.initialLength << unit << details(origOrder, rep.initialToolChanges) << endl;
+    const char* construction = "Greedy";
+    if (cons.empty() && !cons.hasTools()) {
+        if (opt.curve == Curve::Hilbert)     construction = "Hilbert";
+        else if (opt.curve == Curve::Morton) construction = "Morton";
+    }
+    cout << construction << cost << rep.greedyLength << unit << endl;
+
+    const ImproveOptions& improve = opt.improve;
+    if (opt.multi.starts > 1) {
+        const MultiStartResult& ms = rep.multi;
+        cout << "Multi-start" << cost << ms.length << unit
+             << " (best of " << ms.completed << " starts: start " << ms.bestStart
+             << " from point " << ms.startPoint << ", " << ms.threads << " threads, "
+             << fixed << setprecision(3) << ms.seconds << " s)"
+             << defaultfloat << setprecision(6) << endl;
+    } else if (improve.improver == Improver::TwoOpt) {
+        cout << "2-opt" << cost << rep.improvedLength << unit << endl;
+    } else if (improve.improver == Improver::LinKernighan) {
+        cout << "LK" << cost << rep.improvedLength << unit
+             << " (" << rep.main.moves << " moves, " << rep.main.kicks << " kicks, "
+             << fixed << setprecision(3) << rep.main.seconds << " s)"
+             << defaultfloat << setprecision(6) << endl;
+    }
 
-    // Write reordered points
-    writeReorderedPoints(outFile, pts, optOrder);
+    if (improve.orOpt && opt.multi.starts == 1) {
+        double before = rep.improvedLength;
+        const vector<PassReport>& passes = rep.orOpt;
+        for (size_t p = 0; p < passes.size(); ++p) {
+            cout << "Or-opt pass " << p + 1 << ": " << passes[p].moves << " moves, -"
+                 << passes[p].gain << unit << fixed << setprecision(3)
+                 << " (" << 100.0 * passes[p].gain / before << " %), "
+                 << passes[p].seconds << " s" << defaultfloat << setprecision(6) << endl;
+            before -= passes[p].gain;
+        }
+        cout << "Or-opt" << cost << rep.length << unit << endl;
+    }
 
-   //------------------------------------------------------------------------------
-// Visualization: three separate canvases for original, optimized, and comparison
-//------------------------------------------------------------------------------
-gStyle->SetOptStat(0);
-
-// --- 1. Original path ---
-TCanvas* c1 = new TCanvas("c1", "Original Path", 800, 600);
-(void)c1;
-TGraph* gOrig = new TGraph(pts.size());
-for (size_t i = 0; i < pts.size(); ++i)
-    gOrig->SetPoint(i, pts[origOrder[i]].coords[0], pts[origOrder[i]].coords[1]);
-gOrig->SetLineColor(kRed);
-gOrig->SetLineWidth(2);
-gOrig->SetMarkerStyle(20);
-gOrig->SetTitle("Original Path;X;Y");
-gOrig->Draw("ALP");
-
-TLegend* leg1 = new TLegend(0.75, 0.82, 0.92, 0.9);
-leg1->AddEntry(gOrig, "Original Path", "lp");
-leg1->Draw();
-
-// --- 2. Optimized path ---
-TCanvas* c2 = new TCanvas("c2", "Optimized Path", 800, 600);
-(void)c2;
-TGraph* gOpt = new TGraph(pts.size());
-for (size_t i = 0; i < pts.size(); ++i)
-    gOpt->SetPoint(i, pts[optOrder[i]].coords[0], pts[optOrder[i]].coords[1]);
-gOpt->SetLineColor(kBlue);
-gOpt->SetLineWidth(2);
-gOpt->SetMarkerStyle(21);
-gOpt->SetTitle("Optimized Path;X;Y");
-gOpt->Draw("ALP");
-
-TLegend* leg2 = new TLegend(0.75, 0.82, 0.92, 0.9);
-leg2->AddEntry(gOpt, "Optimized Path", "lp");
-leg2->Draw();
-
-// --- 3. Comparison: both paths superimposed ---
-TCanvas* c3 = new TCanvas("c3", "Comparison: Original vs Optimized", 900, 700);
-(void)c3;
-TGraph* gOrig2 = new TGraph(*gOrig); // copy
-TGraph* gOpt2  = new TGraph(*gOpt);
-
-gOrig2->SetLineColor(kRed);
-gOrig2->SetLineWidth(2);
-gOrig2->SetMarkerStyle(20);
-gOrig2->SetTitle("Original (Red) vs Optimized (Blue);X;Y");
-
-gOpt2->SetLineColor(kBlue);
-gOpt2->SetLineWidth(2);
-gOpt2->SetMarkerStyle(21);
-
-gOrig2->Draw("ALP");
-gOpt2->Draw("LP SAME");
-
-TLegend* leg3 = new TLegend(0.7, 0.8, 0.9, 0.9);
-leg3->AddEntry(gOrig2, "Original Path", "lp");
-leg3->AddEntry(gOpt2, "Optimized Path", "lp");
-leg3->Draw();
-
-// --- Update and run interactive session ---
-c1->Update();
-c2->Update();
-c3->Update();
-
-app.Run();  // Keeps all canvases open
-
-    return 0;
+    cout << "Optimized" << cost << rep.length << unit << details(rep.order, rep.toolChanges) << endl;
+    if (cons.hasTools()) {
+        cout << "Tool changes: " << rep.initialToolChanges << " initial, " << rep.toolChanges << " optimized; "
+             << (timed ? "estimated time saved " : "path cost saved ") << rep.initialLength - rep.length << unit
+             << " (" << cons.toolChangeCost() * (rep.initialToolChanges - rep.toolChanges) << unit
+             << " in tool changes)" << endl;
+    }
+    if (rep.timedOut) {
+        cout << "Time limit of " << timeLimit << " s reached after "
+             << chrono::duration<double>(Deadline::Clock::now() - startTime).count()
+             << " s; best order so far is used" << endl;
+    }
+
+    // Write reordered points, or the order alone
+    auto tWrite = Deadline::Clock::now();
+    if (!writeReorderedPoints(outFile, cloud, rep.order, outFormat)) {
+        cerr << "Error: cannot write output file " << outFile << endl;
+        return 1;
+    }
+    bool orderOnly = outFormat == PointFormat::OrderText || outFormat == PointFormat::OrderBinary;
+    cout << (orderOnly ? "Wrote visiting order to " : "Wrote reordered points to ") << outFile << endl;
+    if (stats) {
+        cout << "Write time: " << fixed << setprecision(3)
+             << chrono::duration<double>(Deadline::Clock::now() - tWrite).count() << " s"
+             << defaultfloat << setprecision(6) << endl;
+    }
+
+    if (batch) return 0;
+    return showPaths(argc, argv, coords, origOrder, rep.order);
 }
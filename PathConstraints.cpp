@@ -0,0 +1,224 @@
+// ============================================================================
+// File: PathConstraints.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Visiting-order constraints and the constraint file reader (see
+//   PathConstraints.h).
+// ============================================================================
+
+#include "PathConstraints.h"
+#include "PathIO.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Construction: dense group ranks, same-group pairs in adjacency arrays
+//------------------------------------------------------------------------------
+PathConstraints::PathConstraints(int n, const vector<int>& rank, const vector<pair<int, int>>& before)
+    : group(n, 0) {
+    if (!rank.empty()) {
+        vector<int> ranks(rank);
+        sort(ranks.begin(), ranks.end());
+        ranks.erase(unique(ranks.begin(), ranks.end()), ranks.end());
+        nGroups = max(1, static_cast<int>(ranks.size()));
+        for (int i = 0; i < n; ++i)
+            group[i] = static_cast<int>(lower_bound(ranks.begin(), ranks.end(), rank[i]) - ranks.begin());
+    }
+    for (const auto& pr : before)
+        if (group[pr.first] == group[pr.second] && pr.first != pr.second) pairs.push_back(pr);
+
+    nPred.assign(n, 0);
+    succFirst.assign(n + 1, 0);
+    linkFirst.assign(n + 1, 0);
+    for (const auto& pr : pairs) {
+        ++succFirst[pr.first + 1];
+        ++linkFirst[pr.first + 1];
+        ++linkFirst[pr.second + 1];
+        ++nPred[pr.second];
+    }
+    for (int i = 0; i < n; ++i) {
+        succFirst[i + 1] += succFirst[i];
+        linkFirst[i + 1] += linkFirst[i];
+    }
+    succ.resize(pairs.size());
+    link.resize(2 * pairs.size());
+    vector<int> s(succFirst.begin(), succFirst.end() - 1);
+    vector<int> l(linkFirst.begin(), linkFirst.end() - 1);
+    for (const auto& pr : pairs) {
+        succ[s[pr.first]++] = pr.second;
+        link[l[pr.first]++] = pr.second;
+    }
+    for (const auto& pr : pairs) link[l[pr.second]++] = pr.first;
+
+    active = nGroups > 1 || !pairs.empty();
+}
+
+//------------------------------------------------------------------------------
+// Tools
+//------------------------------------------------------------------------------
+void PathConstraints::setTools(const vector<int>& toolOfPoint, double changeCost) {
+    int n = static_cast<int>(toolOfPoint.size());
+    if (static_cast<int>(group.size()) != n) *this = PathConstraints(n, vector<int>(), vector<pair<int, int>>());
+
+    vector<int> ids(toolOfPoint);
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    nTools = max(1, static_cast<int>(ids.size()));
+    tool.resize(n);
+    for (int i = 0; i < n; ++i)
+        tool[i] = static_cast<int>(lower_bound(ids.begin(), ids.end(), toolOfPoint[i]) - ids.begin());
+    toolCost = nTools > 1 ? changeCost : 0.0;
+}
+
+long PathConstraints::countToolChanges(const vector<int>& order, bool closed) const {
+    long changes = 0;
+    if (tool.empty() || order.empty()) return changes;
+    for (size_t i = 1; i < order.size(); ++i) changes += tool[order[i]] != tool[order[i - 1]];
+    if (closed) changes += tool[order.back()] != tool[order[0]];
+    return changes;
+}
+
+//------------------------------------------------------------------------------
+// Feasibility
+//------------------------------------------------------------------------------
+int PathConstraints::findCycle() const {
+    // Take out points without remaining predecessors (Kahn); whatever is
+    // left lies on a cycle or behind one
+    int n = static_cast<int>(group.size());
+    vector<int> waiting(nPred);
+    vector<int> ready;
+    for (int i = 0; i < n; ++i)
+        if (waiting[i] == 0) ready.push_back(i);
+    int done = 0;
+    while (!ready.empty()) {
+        int v = ready.back();
+        ready.pop_back();
+        ++done;
+        for (const int* w = succBegin(v); w != succEnd(v); ++w)
+            if (--waiting[*w] == 0) ready.push_back(*w);
+    }
+    if (done == n) return -1;
+
+    // Walking back through left-over predecessors ends up on the cycle
+    int v = 0;
+    while (waiting[v] == 0) ++v;
+    for (int step = 0; step < n; ++step) {
+        int k = linkFirst[v] + (succFirst[v + 1] - succFirst[v]);   // first predecessor
+        while (waiting[link[k]] == 0) ++k;
+        v = link[k];
+    }
+    return v;
+}
+
+bool PathConstraints::canStart(int i) const {
+    return !active || (group[i] == 0 && nPred[i] == 0);
+}
+
+bool PathConstraints::canEnd(int i) const {
+    return !active || (group[i] == nGroups - 1 && succBegin(i) == succEnd(i));
+}
+
+int PathConstraints::firstStart() const {
+    int n = static_cast<int>(group.size());
+    for (int i = 0; i < n; ++i)
+        if (canStart(i)) return i;
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+// Constraint file
+//------------------------------------------------------------------------------
+bool loadConstraints(const string& path, const LabelIndex& labels, int n,
+                     PathConstraints& cons, string& error) {
+    ifstream in(path);
+    if (!in) {
+        error = path + ": cannot open constraint file";
+        return false;
+    }
+
+    struct Before {
+        int a, b;
+        string where, labelA, labelB;
+    };
+    vector<int> rank;
+    int groups = 0;
+    vector<Before> before;
+
+    string line;
+    for (int lineNo = 1; getline(in, line); ++lineNo) {
+        line = line.substr(0, line.find('#'));
+        istringstream fields(line);
+        string key;
+        if (!(fields >> key)) continue;   // blank or comment
+
+        string where = path + ":" + to_string(lineNo) + ": ";
+        vector<string> names;
+        vector<int> pts;
+        for (string label; fields >> label;) {
+            int i = labels.find(label);
+            if (i < 0 || i >= n) {
+                error = where + "no point labeled '" + label + "'";
+                return false;
+            }
+            names.push_back(label);
+            pts.push_back(i);
+        }
+
+        if (key == "group") {
+            if (pts.empty()) {
+                error = where + "'group' needs at least one label";
+                return false;
+            }
+            if (rank.empty()) rank.assign(n, -1);
+            for (size_t k = 0; k < pts.size(); ++k) {
+                if (rank[pts[k]] >= 0) {
+                    error = where + "'" + names[k] + "' is already in a group";
+                    return false;
+                }
+                rank[pts[k]] = groups;
+            }
+            ++groups;
+        } else if (key == "before") {
+            if (pts.size() != 2) {
+                error = where + "'before' needs two labels";
+                return false;
+            }
+            if (pts[0] == pts[1]) {
+                error = where + "'" + names[0] + "' cannot come before itself";
+                return false;
+            }
+            before.push_back({pts[0], pts[1], where, names[0], names[1]});
+        } else {
+            error = where + "unknown constraint '" + key + "' (use group or before)";
+            return false;
+        }
+    }
+    for (int& r : rank)
+        if (r < 0) r = groups;   // unlisted points: one more group, visited last
+
+    vector<pair<int, int>> pairs;
+    for (const Before& b : before) pairs.push_back({b.a, b.b});
+    PathConstraints c(n, rank, pairs);
+
+    for (const Before& b : before) {
+        if (c.groupOf(b.a) > c.groupOf(b.b)) {
+            error = b.where + "'" + b.labelA + "' must come before '" + b.labelB + "' but is in a later group";
+            return false;
+        }
+    }
+    int v = c.findCycle();
+    if (v >= 0) {
+        auto it = find_if(before.begin(), before.end(), [&](const Before& b) { return b.a == v; });
+        error = path + ": the 'before' pairs form a cycle through '" + it->labelA + "'";
+        return false;
+    }
+
+    cons = move(c);
+    return true;
+}
@@ -0,0 +1,195 @@
+// ============================================================================
+// File: PathConstraints.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Visiting-order constraints (--constraints): ordered groups and pairwise
+//   precedence.  Groups are visited one after the other in increasing rank,
+//   e.g. the datum points first and then the features of each probe
+//   orientation; "a before b" pairs order points inside a group.  A pair
+//   between two groups is already decided by their ranks and is dropped.
+//
+//   The stages keep an order feasible instead of repairing it:
+//     - the greedy construction only offers the points of the current group
+//       whose predecessors have all been visited (PathOptimizer.cpp);
+//     - every local-search move is checked before it is applied, in O(1)
+//       for the groups and in time proportional to the moved stretch (or to
+//       the number of pairs, if smaller) for the precedence pairs.
+//   The checks rely on the order being feasible to begin with: group ranks
+//   never decrease along the path, so a stretch of the path lies inside one
+//   group exactly when its two end points do.
+//
+//   Constraint file (one constraint per line, '#' starts a comment, points
+//   named by label):
+//       group D1 D2 D3        # datum points, visited first
+//       group F1 F2 F3 F4     # features probed from +X
+//       group G1 G2           # features probed from -Y
+//       before F3 F1          # F3 is measured before F1
+//   The group lines give the visiting order of the groups; points that are
+//   not listed form one more group, visited last.
+//
+//   Tools (--tool-change) are a cost rather than a constraint: every change
+//   of tool (probe tip) between consecutive points of the path adds a fixed
+//   cost to the move, so the stages minimize travel plus tool changes, a
+//   clustered TSP with one cluster per tool.  The greedy walk stays on the
+//   current tool while its nearest point is closer than a change costs, and
+//   the local searches charge the change on the edges (EdgeCost in
+//   LocalSearch.h).
+// ============================================================================
+
+#ifndef PATHCONSTRAINTS_H
+#define PATHCONSTRAINTS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Tour.h"
+
+class LabelIndex;
+
+class PathConstraints {
+public:
+    // No constraints
+    PathConstraints() = default;
+
+    // Constraints on n points: group[i] is the rank of point i (any
+    // integers; empty for a single group) and 'before' lists pairs (a, b)
+    // with a visited before b.  Pairs against the group order cannot be
+    // met and are ignored (loadConstraints() rejects them).
+    PathConstraints(int n, const std::vector<int>& group,
+                    const std::vector<std::pair<int, int>>& before);
+
+    // No groups or pairs (tools may still be set)
+    bool empty() const { return !active; }
+    int groupCount() const { return nGroups; }
+    int pairCount() const { return static_cast<int>(pairs.size()); }
+
+    // Group of point i, numbered 0 .. groupCount() - 1 in visiting order
+    int groupOf(int i) const { return group[i]; }
+
+    // A point on a precedence cycle, or -1 if there is none
+    int findCycle() const;
+
+    // Can point i come first (last) in some feasible order?
+    bool canStart(int i) const;
+    bool canEnd(int i) const;
+
+    // Lowest point index that can come first, -1 if none
+    int firstStart() const;
+
+    // Same-group successors of point i in the precedence pairs, and the
+    // number of its same-group predecessors
+    const int* succBegin(int i) const { return succ.data() + succFirst[i]; }
+    const int* succEnd(int i) const { return succ.data() + succFirst[i + 1]; }
+    int predCount(int i) const { return nPred[i]; }
+
+    // Tool of each point (any integers) and the cost of one change, in the
+    // units of the metric (seconds for the time metrics)
+    void setTools(const std::vector<int>& tool, double changeCost);
+
+    bool hasTools() const { return toolCost > 0.0; }
+    int toolCount() const { return nTools; }
+    int toolOf(int i) const { return tool[i]; }     // 0 .. toolCount() - 1
+    double toolChangeCost() const { return toolCost; }
+
+    // Cost of the tool change on the move from a to b (0 without tools)
+    double changeCost(int a, int b) const {
+        return hasTools() && tool[a] != tool[b] ? toolCost : 0.0;
+    }
+
+    // Tool changes along an order (including the return to order[0] of a
+    // closed path), and their cost
+    long countToolChanges(const std::vector<int>& order, bool closed = false) const;
+    double toolChangesCost(const std::vector<int>& order, bool closed = false) const {
+        return hasTools() ? toolCost * countToolChanges(order, closed) : 0.0;
+    }
+
+    //--------------------------------------------------------------------------
+    // Move checks on the array tour of the local searches (Tour.h), which
+    // must hold a feasible order.  They return true for no constraints.
+    //--------------------------------------------------------------------------
+
+    // 2-opt flip Tour::move2opt(a, b, c, d): the path reverses the arc
+    // between the two removed edges that does not hold the depot
+    bool allowsFlip(const Tour& tour, int a, int b, int c, int d) const {
+        if (!active) return true;
+        int x = b, y = c;
+        if (tour.next(a) != b) { x = a; y = d; }
+        if (tour.between(x, tour.depot(), y)) {
+            int nx = tour.next(y);
+            y = tour.prev(x);
+            x = nx;
+        }
+        if (group[x] != group[y]) return false;
+        return pairs.empty() || !linkedInside(tour, x, y, x, y);
+    }
+
+    // Or-opt: the forward segment s1..s2, between p and nx, moves into the
+    // forward edge (u, v), possibly reversed.  In the path it passes over
+    // the arc nx..u or v..p, whichever does not hold the depot.
+    bool allowsMove(const Tour& tour, int s1, int s2, int p, int nx, int u, int v, bool reversed) const {
+        if (!active) return true;
+        int x = nx, y = u;
+        if (tour.between(x, tour.depot(), y)) { x = v; y = p; }
+        int g = group[s1];
+        if (group[s2] != g || group[x] != g || group[y] != g) return false;
+        if (pairs.empty()) return true;
+        return !linkedInside(tour, s1, s2, x, y) && !(reversed && linkedInside(tour, s1, s2, s1, s2));
+    }
+
+    // Double bridge: the forward segments b1..bk and c1..cm, consecutive on
+    // the tour, trade places.  Refused if the depot is inside them.
+    bool allowsSwap(const Tour& tour, int b1, int bk, int c1, int cm) const {
+        if (!active) return true;
+        for (int v = b1;; v = tour.next(v)) {
+            if (tour.isDepot(v)) return false;
+            if (v == cm) break;
+        }
+        int g = group[b1];
+        if (group[bk] != g || group[c1] != g || group[cm] != g) return false;
+        return pairs.empty() || !linkedInside(tour, b1, bk, c1, cm);
+    }
+
+private:
+    // Is a point of the forward arc s..e paired with a point of the forward
+    // arc x..y?  Walks s..e, or scans all pairs if there are fewer of them.
+    bool linkedInside(const Tour& tour, int s, int e, int x, int y) const {
+        int len = tour.pos(e) - tour.pos(s);
+        if (len < 0) len += tour.size();
+        if (static_cast<size_t>(len) < pairs.size()) {
+            for (int v = s;; v = tour.next(v)) {
+                for (int k = linkFirst[v]; k < linkFirst[v + 1]; ++k)
+                    if (tour.between(x, link[k], y)) return true;
+                if (v == e) return false;
+            }
+        }
+        for (const auto& pr : pairs) {
+            if (tour.between(s, pr.first, e) && tour.between(x, pr.second, y)) return true;
+            if (tour.between(s, pr.second, e) && tour.between(x, pr.first, y)) return true;
+        }
+        return false;
+    }
+
+    bool active = false;
+    int nGroups = 1;
+    std::vector<int> group;                      // per point, dense ranks
+    std::vector<std::pair<int, int>> pairs;      // same-group pairs
+    std::vector<int> succFirst, succ;            // successors of each point
+    std::vector<int> nPred;                      // predecessors of each point
+    std::vector<int> linkFirst, link;            // successors, then predecessors
+
+    int nTools = 1;
+    double toolCost = 0.0;
+    std::vector<int> tool;                       // per point, dense ids
+};
+
+// Read a constraint file (see above) naming the points of a cloud of n
+// points by label.  On failure returns false and sets error to a message
+// naming the file and line; 'cons' is then left unchanged.  Contradicting
+// pairs and precedence cycles are reported as errors too.
+bool loadConstraints(const std::string& path, const LabelIndex& labels, int n,
+                     PathConstraints& cons, std::string& error);
+
+#endif
@@ -0,0 +1,25 @@
+// ============================================================================
+// File: PathEnds.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Where a path starts and ends (--start, --end, --closed).  Every stage
+//   keeps these: the greedy construction starts at 'start' and leaves 'end'
+//   for last, and the local searches pin the matching tour edges (Tour.h).
+//
+//   A closed path returns to its start after the last point.  The return
+//   move is part of the path cost, but the start is not repeated in the
+//   order.
+// ============================================================================
+
+#ifndef PATHENDS_H
+#define PATHENDS_H
+
+struct PathEnds {
+    int start = 0;         // first point
+    int end = -1;          // last point, -1 for a free end
+    bool closed = false;   // return to start; needs end = -1
+};
+
+#endif
@@ -0,0 +1,675 @@
+// ============================================================================
+// File: PathIO.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Input and output of point sets (see PathIO.h).
+// ============================================================================
+
+#include "PathIO.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+// Floating-point <charconv>.  __cpp_lib_to_chars promises to_chars and
+// from_chars for doubles together, which libc++ does not claim, although it
+// has had floating-point to_chars since LLVM 14 (on Apple platforms from
+// macOS 13.3, the Makefile's deployment target) and from_chars since LLVM
+// 20 (not relied on in Apple's system library yet).  Each direction is
+// therefore detected on its own; without it formatRoundTrip() falls back to
+// printf and parseDoubleSlow() to strtod, both in the C locale.
+#if defined(__cpp_lib_to_chars)
+#define PATHIO_TO_CHARS_DOUBLE 1
+#define PATHIO_FROM_CHARS_DOUBLE 1
+#elif defined(_LIBCPP_VERSION)
+#if _LIBCPP_VERSION >= 14000 && \
+    (!defined(_LIBCPP_AVAILABILITY_HAS_TO_CHARS_FLOATING_POINT) || _LIBCPP_AVAILABILITY_HAS_TO_CHARS_FLOATING_POINT)
+#define PATHIO_TO_CHARS_DOUBLE 1
+#endif
+#if _LIBCPP_VERSION >= 200000 && !defined(__APPLE__)
+#define PATHIO_FROM_CHARS_DOUBLE 1
+#endif
+#endif
+
+#if !defined(PATHIO_TO_CHARS_DOUBLE) || !defined(PATHIO_FROM_CHARS_DOUBLE)
+#define PATHIO_C_LOCALE 1
+#include <locale.h>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+using namespace std;
+
+#if defined(PATHIO_C_LOCALE)
+// The "C" locale, for the printf/strtod fallbacks: neither the output nor
+// the parsing may depend on the decimal separator of the user's locale
+static locale_t cLocale() {
+    static const locale_t c = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+    return c;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Number parsing.  Plain decimals with at most 15 significant digits and 22
+// decimals, by far the common case in scan files, are converted exactly as
+// mantissa / 10^decimals (both exact doubles, so the one division rounds
+// correctly).  Everything else goes through std::from_chars, or where the
+// standard library lacks floating-point from_chars (libc++ before LLVM 20
+// and on Apple platforms) through strtod_l in the C locale, on a
+// NUL-terminated copy of the field.
+//------------------------------------------------------------------------------
+static const double kPow10[23] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static bool parseDoubleSlow(const char* b, const char* e, double& v) {
+    if (b < e && *b == '+') ++b;   // accepted by readPoints(), not by from_chars
+    if (b == e) return false;
+#if defined(PATHIO_FROM_CHARS_DOUBLE)
+    auto res = from_chars(b, e, v);
+    return res.ec == errc() && res.ptr == e;
+#else
+    char buf[64];
+    size_t n = static_cast<size_t>(e - b);
+    if (n >= sizeof(buf)) return false;
+    memcpy(buf, b, n);
+    buf[n] = '\0';
+    char* stop = nullptr;
+    v = strtod_l(buf, &stop, cLocale());
+    return stop == buf + n;
+#endif
+}
+
+// Field separators: commas and blanks.  '\n' also ends a field.
+struct CharClass {
+    bool separator[256] = {};
+    bool fieldEnd[256] = {};
+    CharClass() {
+        for (unsigned char c : {',', ' ', '\t', '\r'}) separator[c] = fieldEnd[c] = true;
+        fieldEnd[static_cast<unsigned char>('\n')] = true;
+    }
+};
+static const CharClass kChars;
+
+static inline bool isSeparator(char c) { return kChars.separator[static_cast<unsigned char>(c)]; }
+static inline bool isFieldEnd(char c)  { return kChars.fieldEnd[static_cast<unsigned char>(c)]; }
+
+// One field of the line being parsed
+struct Field {
+    const char* begin;
+    const char* end;
+    double value;
+    bool parsed;    // value holds the exact fast-path result
+};
+
+// Scan one field starting at p (not a separator), converting it on the way
+// if it is a plain decimal.  Returns the end of the field.
+static inline const char* scanField(const char* p, const char* end, Field& f) {
+    f.begin = p;
+    f.parsed = false;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    uint64_t mantissa = 0;
+    int digits = 0, decimals = 0;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits)
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+    if (p < end && *p == '.') {
+        for (++p; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits, ++decimals)
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+    }
+
+    if (p == end || isFieldEnd(*p)) {
+        if (digits > 0 && digits <= 15 && decimals <= 22) {
+            f.value = static_cast<double>(mantissa) / kPow10[decimals];
+            if (negative) f.value = -f.value;
+            f.parsed = true;
+        }
+    } else {
+        while (p < end && !isFieldEnd(*p)) ++p;   // label, exponent, ...
+    }
+    f.end = p;
+    return p;
+}
+
+static inline bool fieldValue(const Field& f, double& v) {
+    if (f.parsed) {
+        v = f.value;
+        return true;
+    }
+    return parseDoubleSlow(f.begin, f.end, v);
+}
+
+//------------------------------------------------------------------------------
+// Parse the lines in [p, end) in a single pass: the first field and the last
+// three of each line are kept, and the second one too if there are more than
+// four
+//------------------------------------------------------------------------------
+static void parseLines(const char* p, const char* end, PointCloud& cloud) {
+    while (p < end) {
+        while (p < end && isSeparator(*p)) ++p;
+        if (p < end && *p == '#') {   // comment
+            const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+            p = eol ? eol + 1 : end;
+            continue;
+        }
+
+        Field first{}, second{}, last[3]{};
+        int count = 0;
+        while (p < end && *p != '\n') {
+            last[0] = last[1];
+            last[1] = last[2];
+            p = scanField(p, end, last[2]);
+            if (count++ == 0) first = last[2];
+            else if (count == 2) second = last[2];
+            while (p < end && isSeparator(*p)) ++p;
+        }
+        if (p < end) ++p;   // past '\n'
+
+        double c[3];
+        if (count < 3 || !fieldValue(last[0], c[0]) || !fieldValue(last[1], c[1]) ||
+            !fieldValue(last[2], c[2]))
+            continue;
+        cloud.coords.x.push_back(c[0]);
+        cloud.coords.y.push_back(c[1]);
+        cloud.coords.z.push_back(c[2]);
+        cloud.labels.push_back(count > 3 ? string_view(first.begin, first.end - first.begin) : string_view());
+        if (count > 4) {
+            cloud.tools.resize(cloud.labels.size() - 1);   // earlier lines without a tool
+            cloud.tools.push_back(string_view(second.begin, second.end - second.begin));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Binary point files (format in PathIO.h)
+//------------------------------------------------------------------------------
+static const char kBinaryMagic[8] = {'P', 'A', 'T', 'H', 'O', 'P', 'T', '\x1a'};
+static const uint32_t kBinaryVersion = 2;   // 1: no tool table, still read
+static const uint32_t kEndianCheck = 0x01020304;
+
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint64_t count;
+    uint64_t labelBytes;
+};
+static_assert(sizeof(BinaryHeader) == 32, "binary header must have no padding");
+
+static bool isBinaryPointFile(const char* data, size_t size) {
+    return size >= sizeof(kBinaryMagic) && memcmp(data, kBinaryMagic, sizeof(kBinaryMagic)) == 0;
+}
+
+// String table at p: uint64 offset[n + 1] (offset[0] = 0), then offset[n]
+// bytes of text, viewed by 'out'.  Returns the end of the table, or nullptr
+// if it does not fit before 'end' or its offsets are corrupt.
+static const char* readStringTable(const char* p, const char* end, uint64_t n, vector<string_view>& out) {
+    if (static_cast<uint64_t>(end - p) / sizeof(uint64_t) < n + 1) return nullptr;
+    const char* text = p + (n + 1) * sizeof(uint64_t);
+    uint64_t bytes;
+    memcpy(&bytes, text - sizeof(uint64_t), sizeof(bytes));
+    if (bytes > static_cast<uint64_t>(end - text)) return nullptr;
+
+    out.resize(n);
+    uint64_t prev;
+    memcpy(&prev, p, sizeof(prev));
+    if (prev != 0) return nullptr;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t next;
+        memcpy(&next, p + (i + 1) * sizeof(uint64_t), sizeof(next));
+        if (next < prev || next > bytes) return nullptr;
+        out[i] = string_view(text + prev, next - prev);
+        prev = next;
+    }
+    return text + bytes;
+}
+
+static bool loadBinaryPoints(const string& path, PointCloud& cloud, string& error) {
+    const char* data = cloud.source.data();
+    const size_t size = cloud.source.size();
+    const char* end = data + size;
+    BinaryHeader h;
+    if (size < sizeof(h)) {
+        error = path + ": truncated binary header";
+        return false;
+    }
+    memcpy(&h, data, sizeof(h));
+    if (h.endian != kEndianCheck) {
+        error = path + ": binary point file written with a different byte order";
+        return false;
+    }
+    if (h.version < 1 || h.version > kBinaryVersion) {
+        error = path + ": unsupported binary point file version " + to_string(h.version);
+        return false;
+    }
+
+    // Sizes checked piecewise so that a corrupt count cannot overflow them
+    size_t rest = size - sizeof(h);
+    uint64_t n = h.count;
+    if (rest < sizeof(uint64_t) || n > (rest - sizeof(uint64_t)) / (4 * sizeof(double))) {
+        error = path + ": binary point file size does not match its header";
+        return false;
+    }
+
+    const char* coords = data + sizeof(h);
+    PointSet& ps = cloud.coords;
+    ps.x.resize(n);
+    ps.y.resize(n);
+    ps.z.resize(n);
+    if (n > 0) {
+        memcpy(ps.x.data(), coords, n * sizeof(double));
+        memcpy(ps.y.data(), coords + n * sizeof(double), n * sizeof(double));
+        memcpy(ps.z.data(), coords + 2 * n * sizeof(double), n * sizeof(double));
+    }
+
+    const char* offsets = coords + 3 * n * sizeof(double);
+    const char* labelText = offsets + (n + 1) * sizeof(uint64_t);
+    const char* p = readStringTable(offsets, end, n, cloud.labels);
+    if (!p || static_cast<uint64_t>(p - labelText) != h.labelBytes) {
+        error = path + ": corrupt label table in binary point file";
+        cloud = PointCloud();
+        return false;
+    }
+
+    // Version 2: a tool flag, and with tools a second string table
+    if (h.version >= 2) {
+        uint64_t hasTools = 2;
+        if (static_cast<size_t>(end - p) >= sizeof(hasTools)) memcpy(&hasTools, p, sizeof(hasTools));
+        p += sizeof(hasTools);
+        if (hasTools > 1 || p > end || (hasTools == 1 && !(p = readStringTable(p, end, n, cloud.tools)))) {
+            error = path + ": corrupt tool table in binary point file";
+            cloud = PointCloud();
+            return false;
+        }
+    }
+    if (p != end) {
+        error = path + ": binary point file size does not match its header";
+        cloud = PointCloud();
+        return false;
+    }
+    return true;
+}
+
+// String table of the views in 'order' (see readStringTable())
+static void writeStringTable(ofstream& out, const vector<string_view>& views, const vector<int>& order) {
+    vector<uint64_t> offset(order.size() + 1, 0);
+    for (size_t i = 0; i < order.size(); ++i) offset[i + 1] = offset[i] + views[order[i]].size();
+    out.write(reinterpret_cast<const char*>(offset.data()), offset.size() * sizeof(uint64_t));
+    for (int idx : order) out.write(views[idx].data(), views[idx].size());
+}
+
+static bool writeBinaryPoints(const string& outFile, const PointCloud& cloud, const vector<int>& order) {
+    ofstream out(outFile, ios::binary);
+    if (!out.is_open()) return false;
+
+    BinaryHeader h;
+    memcpy(h.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    h.version = kBinaryVersion;
+    h.endian = kEndianCheck;
+    h.count = order.size();
+    h.labelBytes = 0;
+    for (int idx : order) h.labelBytes += cloud.labels[idx].size();
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    vector<double> column(order.size());
+    for (const AlignedVector* c : {&cloud.coords.x, &cloud.coords.y, &cloud.coords.z}) {
+        for (size_t i = 0; i < order.size(); ++i) column[i] = (*c)[order[i]];
+        out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(double));
+    }
+    writeStringTable(out, cloud.labels, order);
+
+    uint64_t hasTools = cloud.tools.empty() ? 0 : 1;
+    out.write(reinterpret_cast<const char*>(&hasTools), sizeof(hasTools));
+    if (hasTools) writeStringTable(out, cloud.tools, order);
+
+    out.close();
+    return !out.fail();
+}
+
+//------------------------------------------------------------------------------
+// Fast text reader.  The file is cut into chunks of at least kMinChunkBytes,
+// each ending just after a newline; every chunk is parsed into its own slot
+// and the slots are copied into the result in file order.
+//------------------------------------------------------------------------------
+static const size_t kMinChunkBytes = size_t(1) << 20;
+static const int kChunksPerThread = 4;   // evens out chunks of unequal cost
+
+static double secondsSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static void reserveFor(PointCloud& cloud, size_t bytes) {
+    size_t guess = bytes / 30 + 1;   // rough capacity guess: about 30 bytes per line
+    cloud.coords.x.reserve(guess);
+    cloud.coords.y.reserve(guess);
+    cloud.coords.z.reserve(guess);
+    cloud.labels.reserve(guess);
+}
+
+bool loadPoints(const string& path, PointCloud& cloud, string& error, int threads, LoadStats* stats) {
+    auto t0 = chrono::steady_clock::now();
+    cloud = PointCloud();
+    if (!cloud.source.open(path)) {
+        error = cloud.source.error();
+        return false;
+    }
+    double mapSeconds = secondsSince(t0);
+
+    auto t1 = chrono::steady_clock::now();
+    const char* data = cloud.source.data();
+    const size_t size = cloud.source.size();
+
+    if (isBinaryPointFile(data, size)) {
+        if (!loadBinaryPoints(path, cloud, error)) return false;
+        if (stats) {
+            *stats = LoadStats();
+            stats->bytes = size;
+            stats->points = cloud.size();
+            stats->chunks = 0;
+            stats->mapSeconds = mapSeconds;
+            stats->parseSeconds = secondsSince(t1);
+        }
+        return true;
+    }
+
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    size_t maxChunks = max<size_t>(1, size / kMinChunkBytes);
+    int nChunks = static_cast<int>(min<size_t>(maxChunks, size_t(threads) * kChunksPerThread));
+    threads = min(threads, nChunks);
+
+    if (nChunks == 1) {
+        reserveFor(cloud, size);
+        parseLines(data, data + size, cloud);
+        if (!cloud.tools.empty()) cloud.tools.resize(cloud.size());
+    } else {
+        // Chunk boundaries, moved forward to just after the next newline
+        vector<const char*> bounds(nChunks + 1, data + size);
+        bounds[0] = data;
+        for (int c = 1; c < nChunks; ++c) {
+            const char* p = max(bounds[c - 1], data + size * c / nChunks);
+            const char* eol = static_cast<const char*>(memchr(p, '\n', data + size - p));
+            bounds[c] = eol ? eol + 1 : data + size;
+        }
+
+        vector<PointCloud> parts(nChunks);
+        vector<size_t> offset(nChunks + 1, 0);
+        {
+            ThreadPool pool(threads);
+            for (int c = 0; c < nChunks; ++c) {
+                pool.submit([&, c] {
+                    reserveFor(parts[c], bounds[c + 1] - bounds[c]);
+                    parseLines(bounds[c], bounds[c + 1], parts[c]);
+                });
+            }
+            pool.wait();
+
+            for (int c = 0; c < nChunks; ++c) offset[c + 1] = offset[c] + parts[c].size();
+            size_t n = offset[nChunks];
+            cloud.coords.x.resize(n);
+            cloud.coords.y.resize(n);
+            cloud.coords.z.resize(n);
+            cloud.labels.resize(n);
+            for (int c = 0; c < nChunks; ++c)
+                if (!parts[c].tools.empty()) cloud.tools.resize(n);
+
+            for (int c = 0; c < nChunks; ++c) {
+                pool.submit([&, c] {
+                    PointCloud& part = parts[c];
+                    copy(part.coords.x.begin(), part.coords.x.end(), cloud.coords.x.begin() + offset[c]);
+                    copy(part.coords.y.begin(), part.coords.y.end(), cloud.coords.y.begin() + offset[c]);
+                    copy(part.coords.z.begin(), part.coords.z.end(), cloud.coords.z.begin() + offset[c]);
+                    copy(part.labels.begin(), part.labels.end(), cloud.labels.begin() + offset[c]);
+                    copy(part.tools.begin(), part.tools.end(), cloud.tools.begin() + offset[c]);
+                    part = PointCloud();
+                });
+            }
+            pool.wait();
+        }
+    }
+
+    if (stats) {
+        stats->bytes = size;
+        stats->points = cloud.size();
+        stats->threads = threads;
+        stats->chunks = nChunks;
+        stats->mapSeconds = mapSeconds;
+        stats->parseSeconds = secondsSince(t1);
+    }
+    return true;
+}
+
+PointCloud pointCloudFromPoints(const vector<Point>& pts) {
+    PointCloud cloud;
+    cloud.coords = PointSet(pts);
+    cloud.ownedLabels.reserve(pts.size());
+    for (const Point& p : pts) cloud.ownedLabels.push_back(p.label);
+    for (const string& s : cloud.ownedLabels) cloud.labels.push_back(s);
+    return cloud;
+}
+
+LabelIndex::LabelIndex(const PointCloud& cloud) {
+    index.reserve(cloud.labels.size());
+    for (size_t i = 0; i < cloud.labels.size(); ++i)
+        if (!cloud.labels[i].empty()) index.emplace(cloud.labels[i], static_cast<int>(i));
+}
+
+//------------------------------------------------------------------------------
+// Buffered text output.  Fields are formatted straight into a 1 MB buffer
+// that goes to fwrite() in large blocks.  Doubles are written in their
+// shortest round-trip form (std::to_chars without a precision), so reading
+// the output back gives bit-identical coordinates.  Where the standard
+// library lacks floating-point to_chars, the numbers the fast path below
+// does not take are written with printf and the fewest significant digits
+// that round-trip: as short, but possibly in the other notation.
+//------------------------------------------------------------------------------
+#if !defined(PATHIO_TO_CHARS_DOUBLE)
+static char* formatShortest(char* p, double v) {
+    locale_t previous = uselocale(cLocale());
+    int n = 0;
+    // Up to 15 digits always round-trip for normal doubles; subnormals have
+    // fewer significant bits and may need fewer digits
+    int fewest = fabs(v) < numeric_limits<double>::min() ? 1 : 15;
+    for (int digits = fewest; digits <= 17; ++digits) {
+        n = snprintf(p, 32, "%.*g", digits, v);
+        if (digits == 17 || strtod_l(p, nullptr, cLocale()) == v) break;
+    }
+    uselocale(previous);
+    return p + n;
+}
+#endif
+
+// Shortest round-trip text of v.  Measured coordinates usually have a few
+// decimals, i.e. v is the double nearest to m / 10^k for a small k.  While
+// v * 10^k stays below 1e15 at most one integer m can round-trip, so the
+// first k for which the rounded product does is the string to_chars would
+// pick (fewest characters), and it is written directly unless to_chars would
+// prefer scientific notation.  Everything else goes to to_chars itself.
+static char* formatRoundTrip(char* p, double v) {
+    double a = v < 0 ? -v : v;
+    if (a >= 1e-3 && a < 1e15) {
+        for (int k = 0; k <= 9; ++k) {
+            double scaled = a * kPow10[k];
+            if (scaled >= 1e15) break;   // ulp(scaled) <= 1/8: at most one integer can round-trip
+            double m = static_cast<double>(static_cast<int64_t>(scaled + 0.5));
+            if (fabs(scaled - m) > m * 1e-15 || m / kPow10[k] != a) continue;
+
+            char d[20];   // digits of m
+            int nd = 0;
+            for (uint64_t n = static_cast<uint64_t>(m); n; n /= 10) d[nd++] = char('0' + n % 10);
+            int fixedLen = nd > k ? nd + (k > 0) : 2 + k;
+            int sig = nd;
+            while (sig > 1 && d[nd - sig] == '0') --sig;
+            int e = nd - k - 1;
+            int sciLen = sig + (sig > 1) + 2 + ((e < 0 ? -e : e) >= 100 ? 3 : 2);
+            if (sciLen < fixedLen) break;
+
+            if (v < 0) *p++ = '-';
+            if (nd <= k) {
+                *p++ = '0';
+                *p++ = '.';
+                for (int i = nd; i < k; ++i) *p++ = '0';
+            }
+            for (int i = nd - 1; i >= 0; --i) {
+                *p++ = d[i];
+                if (i == k && k > 0) *p++ = '.';
+            }
+            return p;
+        }
+    }
+#if defined(PATHIO_TO_CHARS_DOUBLE)
+    return to_chars(p, p + 32, v).ptr;
+#else
+    return formatShortest(p, v);
+#endif
+}
+
+class OutputBuffer {
+public:
+    explicit OutputBuffer(const string& path) : file(fopen(path.c_str(), "wb")), buf(kSize) {}
+    ~OutputBuffer() { if (file) fclose(file); }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void put(char c) {
+        room(1);
+        buf[used++] = c;
+    }
+
+    void put(string_view s) {
+        if (s.size() > kSize) {
+            flush();
+            fwrite(s.data(), 1, s.size(), file);
+            return;
+        }
+        room(s.size());
+        memcpy(buf.data() + used, s.data(), s.size());
+        used += s.size();
+    }
+
+    void put(double v) {
+        room(kSlack);
+        used = formatRoundTrip(buf.data() + used, v) - buf.data();
+    }
+
+    void put(uint64_t v) {
+        room(kSlack);
+        char* p = buf.data() + used;
+        used = to_chars(p, p + kSlack, v).ptr - buf.data();
+    }
+
+    // Flush and close; false if anything failed to reach the file
+    bool close() {
+        flush();
+        bool ok = !ferror(file);
+        ok = fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    static const size_t kSize = size_t(1) << 20;
+    static const size_t kSlack = 64;   // room for any one formatted number
+
+    void room(size_t n) {
+        if (used + n > buf.size()) flush();
+    }
+    void flush() {
+        if (used) fwrite(buf.data(), 1, used, file);
+        used = 0;
+    }
+
+    FILE* file;
+    vector<char> buf;
+    size_t used = 0;
+};
+
+static bool writeCsvPoints(const string& outFile, const PointCloud& cloud, const vector<int>& order) {
+    OutputBuffer out(outFile);
+    if (!out.isOpen()) return false;
+    bool tools = !cloud.tools.empty();
+    for (int idx : order) {
+        out.put(cloud.labels[idx]);
+        out.put(',');
+        if (tools) {
+            out.put(cloud.tools[idx]);
+            out.put(',');
+        }
+        out.put(cloud.coords.x[idx]);
+        out.put(',');
+        out.put(cloud.coords.y[idx]);
+        out.put(',');
+        out.put(cloud.coords.z[idx]);
+        out.put('\n');
+    }
+    return out.close();
+}
+
+static bool writeOrderText(const string& outFile, const vector<int>& order) {
+    OutputBuffer out(outFile);
+    if (!out.isOpen()) return false;
+    for (int idx : order) {
+        out.put(static_cast<uint64_t>(idx));
+        out.put('\n');
+    }
+    return out.close();
+}
+
+static bool writeOrderBinary(const string& outFile, const vector<int>& order) {
+    vector<uint32_t> perm(order.begin(), order.end());
+    FILE* file = fopen(outFile.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(perm.data(), sizeof(uint32_t), perm.size(), file) == perm.size();
+    return fclose(file) == 0 && ok;
+}
+
+//------------------------------------------------------------------------------
+// Write points in specified order to CSV
+//------------------------------------------------------------------------------
+bool writeReorderedPoints(const string& outFile, const vector<Point>& pts, const vector<int>& order) {
+    OutputBuffer out(outFile);
+    if (!out.isOpen()) return false;
+    for (int idx : order) {
+        out.put(pts[idx].label);
+        for (int k = 0; k < 3; ++k) {
+            out.put(',');
+            out.put(pts[idx].coords[k]);
+        }
+        out.put('\n');
+    }
+    return out.close();
+}
+
+bool writeReorderedPoints(const string& outFile, const PointCloud& cloud, const vector<int>& order,
+                          PointFormat format) {
+    // Writing over the input file would truncate the mapping the labels
+    // point into: write a new file and rename it over the old one instead
+    if (cloud.source.isMapping(outFile)) {
+        string tmp = outFile + ".tmp";
+        if (!writeReorderedPoints(tmp, cloud, order, format) || rename(tmp.c_str(), outFile.c_str()) != 0) {
+            remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    switch (format) {
+    case PointFormat::Binary:      return writeBinaryPoints(outFile, cloud, order);
+    case PointFormat::OrderText:   return writeOrderText(outFile, order);
+    case PointFormat::OrderBinary: return writeOrderBinary(outFile, order);
+    case PointFormat::Csv:         break;
+    }
+    return writeCsvPoints(outFile, cloud, order);
+}
@@ -0,0 +1,124 @@
+// ============================================================================
+// File: PathIO.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Input and output of point sets.
+//
+//   loadPoints() is the fast reader for large scans: the file is memory-mapped
+//   and parsed in place in one pass (plain decimals converted exactly on the
+//   fly, anything else with std::from_chars, or with strtod_l in the C locale
+//   on libc++ before LLVM 20 and on Apple platforms, which lack floating-point
+//   from_chars), coordinates go straight into a PointSet and labels are kept
+//   as string_views into the mapping, so there is no per-point allocation.  It accepts the same text formats as readPoints()
+//   from ../common:
+//       label,X,Y,Z      or      X,Y,Z
+//   with commas and/or blanks as separators.  Comment lines (starting with
+//   '#') and lines whose coordinates do not parse (headers) are skipped; with
+//   more than three fields the first is the label and the last three are
+//   X, Y, Z.  With more than four the second field is kept as well, as the
+//   tool of the point:
+//       label,tool,X,Y,Z
+//
+//   With several threads the mapped file is cut into newline-aligned chunks
+//   that are parsed in parallel and stitched back in file order, so point i
+//   is always the i-th data line of the file, whatever the thread count.
+//
+//   Binary point files (written with PointFormat::Binary, --write-binary)
+//   skip the parsing altogether.  loadPoints() recognises them by their
+//   magic number, copies the coordinate block into the PointSet and points
+//   the labels and tools into the mapped string tables.  Layout, all
+//   integers and doubles in the byte order of the writing machine
+//   (little-endian on every supported platform):
+//       header   char magic[8] = "PATHOPT\x1a", uint32 version (= 2),
+//                uint32 endian check (= 0x01020304), uint64 n,
+//                uint64 label bytes L                           (32 bytes)
+//       coords   double x[n], y[n], z[n]
+//       labels   uint64 offset[n + 1] (offset[0] = 0, offset[n] = L),
+//                then L bytes of label text without separators
+//       tools    uint64 tool column flag (0 or 1); with 1, a tool table
+//                laid out like the labels (offset[n] = tool bytes)
+//   Version 1 files end after the labels and have no tools; they are still
+//   read.  A reader that finds a version it does not know rejects the file.
+// ============================================================================
+
+#ifndef PATHIO_H
+#define PATHIO_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Points.h"  // from ../common
+#include "PointSet.h"
+#include "MappedFile.h"
+
+// A loaded point set.  Labels view either the mapped input file or
+// ownedLabels, both held here, so a PointCloud can be moved but not copied.
+struct PointCloud {
+    PointSet coords;
+    std::vector<std::string_view> labels;   // empty view for unlabeled lines
+    std::vector<std::string_view> tools;    // empty if no line has a tool, else
+                                            // empty views on lines without one
+
+    MappedFile source;
+    std::vector<std::string> ownedLabels;
+
+    std::size_t size() const { return coords.size(); }
+};
+
+// Point index by label, built once in O(n) by hashing the label views, so
+// that options naming points (--start, --end) do not scan the cloud for each
+// name.  A label used twice resolves to its first point; unlabeled points
+// are not indexed.  The cloud must outlive the index.
+class LabelIndex {
+public:
+    explicit LabelIndex(const PointCloud& cloud);
+
+    // Index of the point labeled 'label', or -1
+    int find(std::string_view label) const {
+        auto it = index.find(label);
+        return it == index.end() ? -1 : it->second;
+    }
+
+private:
+    std::unordered_map<std::string_view, int> index;
+};
+
+// Timing of one loadPoints() call
+struct LoadStats {
+    std::size_t bytes = 0;
+    std::size_t points = 0;
+    int threads = 1;            // threads that parsed
+    int chunks = 1;             // 0 for a binary point file
+    double mapSeconds = 0.0;    // open and map the file
+    double parseSeconds = 0.0;  // parse the chunks and stitch them together,
+                                // or copy out the coordinates of a binary file
+};
+
+// Fast text reader (see above).  threads <= 0 uses one thread per hardware
+// core; files too small to be worth splitting are parsed serially.  Returns
+// false with a message in 'error' if the file cannot be read.
+bool loadPoints(const std::string& path, PointCloud& cloud, std::string& error,
+                int threads = 1, LoadStats* stats = nullptr);
+
+// Output formats.  The Order formats write only the visiting order, as
+// 0-based indices of the points in the input file: one decimal index per
+// line, or a raw array of uint32 in native byte order with no header.
+enum class PointFormat { Csv, Binary, OrderText, OrderBinary };
+
+// Wrap points read by readPoints()
+PointCloud pointCloudFromPoints(const std::vector<Point>& pts);
+
+// Write pts in the given order as "label,X,Y,Z" lines, with coordinates in
+// shortest round-trip form (reading them back gives the same doubles), or
+// "label,tool,X,Y,Z" for a cloud with tools; the PointCloud version can also
+// write a binary point file (see above, tools included) or the order alone.  Returns false if the file cannot be opened or written.
+bool writeReorderedPoints(const std::string& outFile, const std::vector<Point>& pts,
+                          const std::vector<int>& order);
+bool writeReorderedPoints(const std::string& outFile, const PointCloud& cloud,
+                          const std::vector<int>& order, PointFormat format = PointFormat::Csv);
+
+#endif
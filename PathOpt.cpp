@@ -0,0 +1,261 @@
+// ============================================================================
+// File: PathOpt.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Whole-pipeline driver of libpathopt (see PathOpt.h).
+// ============================================================================
+
+#include "PathOpt.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>   // for std::iota
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// The pipeline for one metric
+//------------------------------------------------------------------------------
+template <class Metric>
+static PathOptReport runPipeline(const PointSet& pts, const PathOptOptions& opt, const Deadline& deadline,
+                                 const Metric& metric) {
+    PathOptReport rep;
+    const PathEnds& ends = opt.ends;
+    const PathConstraints& cons = opt.constraints;
+    auto cost = [&](const vector<int>& order) {
+        return computePathLength(pts, order, metric, ends.closed) + cons.toolChangesCost(order, ends.closed);
+    };
+
+    // Initial path
+    vector<int> origOrder(pts.size());
+    iota(origOrder.begin(), origOrder.end(), 0);
+    rep.initialLength = cost(origOrder);
+    rep.initialToolChanges = cons.countToolChanges(origOrder, ends.closed);
+
+    // Greedy or space-filling curve construction
+    if (opt.curve != Curve::None && cons.empty() && !cons.hasTools())
+        rep.order = curvePath(pts, opt.curve, ends, Metric::usesZ);
+    else
+        rep.order = optimizePath(pts, opt.engine, opt.lowestIndexTies, opt.multi.threads, ends, cons, metric);
+    rep.greedyLength = cost(rep.order);
+
+    // Local-search improvement, within the time budget if one was given
+    ImproveOptions improve = opt.improve;
+    if (deadline.isLimited() && !improve.lk.kicks) improve.lk.kicks = -1;   // iterate LK until the deadline
+
+    // The stages report whether the deadline stopped them; empty lists
+    // where some were asked for mean it expired while they were built
+    NeighborLists nbr;
+    if (improve.improver != Improver::None || improve.orOpt || opt.multi.starts > 1) {
+        nbr = buildNeighborLists(pts, opt.neighbors, cons, deadline, metric);
+        if (nbr.k == 0 && opt.neighbors > 0 && pts.size() > 1) rep.timedOut = true;
+    }
+
+    if (opt.multi.starts > 1) {
+        rep.multi = multiStartOptimize(pts, nbr, improve, opt.multi, ends, cons, deadline, metric);
+        rep.order.swap(rep.multi.order);
+        rep.multi.order.clear();
+        if (rep.multi.timedOut) rep.timedOut = true;
+    } else if (improve.improver == Improver::TwoOpt) {
+        rep.main = twoOpt(pts, rep.order, nbr, ends, cons, deadline, metric);
+    } else if (improve.improver == Improver::LinKernighan) {
+        rep.main = linKernighan(pts, rep.order, nbr, improve.lk, ends, cons, deadline, metric);
+    }
+    if (rep.main.timedOut) rep.timedOut = true;
+    rep.improvedLength = cost(rep.order);
+
+    if (improve.orOpt && opt.multi.starts == 1) {
+        rep.orOpt = orOpt(pts, rep.order, nbr, ends, cons, deadline, metric);
+        if (!rep.orOpt.empty() && rep.orOpt.back().timedOut) rep.timedOut = true;
+    }
+
+    rep.length = cost(rep.order);
+    rep.toolChanges = cons.countToolChanges(rep.order, ends.closed);
+    return rep;
+}
+
+// Weights are folded into the coordinates once (and into the clearance
+// plane, a Z coordinate too); the copy only lives for the run, the caller
+// keeps the original coordinates for output
+static MetricOptions weightedMetric(const MetricOptions& metric) {
+    MetricOptions m = metric;
+    m.clearance *= m.weights[2];
+    return m;
+}
+
+PathOptReport optimizeOrder(const PointSet& pts, const PathOptOptions& opt, const Deadline& deadline) {
+    PointSet weighted;
+    const PointSet& run = opt.metric.weighted() ? (weighted = weightedPoints(pts, opt.metric.weights)) : pts;
+
+    return withMetric(weightedMetric(opt.metric), [&](auto metric) { return runPipeline(run, opt, deadline, metric); });
+}
+
+//------------------------------------------------------------------------------
+// Several machines
+//------------------------------------------------------------------------------
+
+// Rounds of cutting and optimizing, and the part of a limited time budget
+// spent on the single path
+static const int kMaxRounds = 8;
+static const double kSinglePathShare = 1.0 / 3.0;
+
+// The tools of the points idx[0], idx[1], ... (no ordering constraints)
+static PathConstraints toolsOf(const PathConstraints& cons, const vector<int>& idx) {
+    PathConstraints tools;
+    if (!cons.hasTools()) return tools;
+    vector<int> tool(idx.size());
+    for (size_t j = 0; j < idx.size(); ++j) tool[j] = cons.toolOf(idx[j]);
+    tools.setTools(tool, cons.toolChangeCost());
+    return tools;
+}
+
+// Cost of every move of 'order', as runPipeline measures it
+static vector<double> moveCosts(const PointSet& pts, const vector<int>& order, const PathOptOptions& opt) {
+    PointSet weighted;
+    const PointSet& run = opt.metric.weighted() ? (weighted = weightedPoints(pts, opt.metric.weights)) : pts;
+    const PathConstraints& cons = opt.constraints;
+
+    return withMetric(weightedMetric(opt.metric), [&](auto metric) {
+        vector<double> cost(order.size() - 1);
+        for (size_t i = 0; i + 1 < order.size(); ++i)
+            cost[i] = moveCost(metric, run, order[i], order[i + 1]) + cons.changeCost(order[i], order[i + 1]);
+        return cost;
+    });
+}
+
+// Cut a path of n points, whose move i costs cost[i], into k consecutive
+// pieces with the smallest possible largest cost: bisection on that cost,
+// each bound checked by cutting greedily.  Returns the first point of each
+// piece.
+static vector<size_t> cutPath(const vector<double>& cost, int k) {
+    size_t n = cost.size() + 1;
+    vector<double> prefix(n, 0.0);
+    for (size_t i = 1; i < n; ++i) prefix[i] = prefix[i - 1] + cost[i - 1];
+
+    auto cut = [&](double limit, vector<size_t>* starts) {
+        int pieces = 1;
+        size_t s = 0;
+        if (starts) starts->assign(1, 0);
+        for (size_t i = 1; i < n; ++i) {
+            if (prefix[i] - prefix[s] > limit) {
+                s = i;
+                ++pieces;
+                if (starts) starts->push_back(i);
+            }
+        }
+        return pieces;
+    };
+
+    double lo = 0.0, hi = prefix[n - 1];
+    for (int it = 0; it < 100; ++it) {
+        double mid = lo + 0.5 * (hi - lo);
+        if (mid <= lo || mid >= hi) break;
+        if (cut(mid, nullptr) <= k) hi = mid;
+        else                        lo = mid;
+    }
+    vector<size_t> starts;
+    cut(hi, &starts);
+
+    // Fewer pieces than machines: halve the pieces with the most points,
+    // which makes no piece more expensive
+    while (static_cast<int>(starts.size()) < k) {
+        size_t best = 0, bestSize = 0;
+        for (size_t p = 0; p < starts.size(); ++p) {
+            size_t size = (p + 1 < starts.size() ? starts[p + 1] : n) - starts[p];
+            if (size > bestSize) {
+                best = p;
+                bestSize = size;
+            }
+        }
+        starts.insert(starts.begin() + best + 1, starts[best] + bestSize / 2);
+    }
+    starts.push_back(n);
+    return starts;
+}
+
+// Optimize every piece as a path of its own, in parallel
+static PartitionReport optimizePieces(const PointSet& pts, const vector<vector<int>>& pieces,
+                                      const PathOptOptions& opt, const Deadline& deadline) {
+    int k = static_cast<int>(pieces.size());
+    PartitionReport part;
+    part.machines.resize(k);
+
+    ThreadPool pool(opt.multi.threads);
+    for (int m = 0; m < k; ++m) {
+        pool.submit([&, m] {
+            const vector<int>& idx = pieces[m];
+            PathOptOptions local = opt;
+            local.ends = PathEnds();
+            local.constraints = toolsOf(opt.constraints, idx);
+            local.multi.threads = 1;
+            Deadline dl = deadline;   // each task polls its own copy
+
+            PathOptReport rep = optimizeOrder(PointSet(pts, idx), local, dl);
+            for (int& i : rep.order) i = idx[i];
+            part.machines[m] = move(rep);
+        });
+    }
+    pool.wait();
+
+    for (const PathOptReport& rep : part.machines) {
+        part.longest = max(part.longest, rep.length);
+        if (rep.timedOut) part.timedOut = true;
+    }
+    return part;
+}
+
+PartitionReport optimizePartition(const PointSet& pts, int machines, const PathOptOptions& opt,
+                                  const Deadline& deadline) {
+    auto t0 = chrono::steady_clock::now();
+    vector<int> all(pts.size());
+    iota(all.begin(), all.end(), 0);
+    PathOptOptions base = opt;
+    base.ends = PathEnds();
+    base.constraints = toolsOf(opt.constraints, all);
+
+    PathOptReport single = optimizeOrder(pts, base, deadline.share(kSinglePathShare));
+    const vector<int>& order = single.order;
+    vector<double> cost = moveCosts(pts, order, base);
+
+    // Optimizing a piece shortens it by a factor of its own.  After each
+    // round the moves of every piece are scaled by the factor it showed and
+    // the single path is cut again, until the cut repeats.
+    PartitionReport best;
+    vector<size_t> lastCut;
+    int rounds = 0;
+    bool timedOut = single.timedOut;
+    while (rounds < kMaxRounds) {
+        vector<size_t> starts = cutPath(cost, machines);
+        if (starts == lastCut) break;
+        lastCut = starts;
+
+        vector<vector<int>> pieces(machines);
+        for (int m = 0; m < machines; ++m)
+            pieces[m].assign(order.begin() + starts[m], order.begin() + starts[m + 1]);
+        PartitionReport part = optimizePieces(pts, pieces, base, deadline.share(1.0 / (kMaxRounds - rounds)));
+        ++rounds;
+        if (part.timedOut) timedOut = true;
+
+        for (int m = 0; m < machines; ++m) {
+            double predicted = 0.0;
+            for (size_t i = starts[m]; i + 1 < starts[m + 1]; ++i) predicted += cost[i];
+            if (predicted <= 0.0) continue;
+            double factor = part.machines[m].length / predicted;
+            for (size_t i = starts[m]; i + 1 < starts[m + 1]; ++i) cost[i] *= factor;
+        }
+        if (rounds == 1 || part.longest < best.longest) best = move(part);
+        if (rounds < kMaxRounds && deadline.expiredNow()) {
+            timedOut = true;
+            break;
+        }
+    }
+
+    best.rounds = rounds;
+    best.singleLength = single.length;
+    best.timedOut = timedOut;
+    best.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return best;
+}
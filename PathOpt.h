@@ -0,0 +1,104 @@
+// ============================================================================
+// File: PathOpt.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Public header of libpathopt, the ROOT-free optimizer core shared by the
+//   OptimizePath command-line tool and by programs that embed the optimizer.
+//   It pulls in the individual stage headers and adds optimizeOrder(), which
+//   runs the whole pipeline (greedy or space-filling curve construction,
+//   candidate lists, multi-start or a single improvement stage, Or-opt)
+//   exactly as OptimizePath does and reports what each stage did.  The
+//   metric of PathOptOptions is dispatched there, once, to the stages
+//   instantiated for it.  optimizePartition() splits the points among
+//   several machines working at once.
+//
+//   Typical use:
+//       std::vector<Point> pts = readPoints("scan.csv", 3);
+//       PathOptReport rep = optimizeOrder(PointSet(pts), PathOptOptions());
+//       writeReorderedPoints("scan_opt.csv", pts, rep.order);
+//
+//   Link with -lpathopt (libpathopt.a or the shared library) and -pthread.
+// ============================================================================
+
+#ifndef PATHOPT_H
+#define PATHOPT_H
+
+#include <vector>
+
+#include "Points.h"  // from ../common
+#include "PointSet.h"
+#include "Metric.h"
+#include "Deadline.h"
+#include "PathEnds.h"
+#include "PathConstraints.h"
+#include "PathOptimizer.h"
+#include "SpaceFillingCurve.h"
+#include "LocalSearch.h"
+#include "MultiStart.h"
+#include "PathIO.h"
+
+struct PathOptOptions {
+    NNEngine engine = NNEngine::KdTree;
+    bool lowestIndexTies = true;
+    Curve curve = Curve::None;      // curve construction instead of the greedy
+                                    // walk (not with constraints or tools, nor
+                                    // for the multi-start walks)
+    ImproveOptions improve;
+    int neighbors = 10;             // candidate list size
+    MultiStartOptions multi;        // multi.threads also drives the brute-force scan
+    MetricOptions metric;           // distance used by every stage
+    PathEnds ends;                  // start, fixed end, closed path
+    PathConstraints constraints;    // ordered groups, precedence pairs, tools
+};
+
+// Lengths are measured in the configured (weighted) metric and include the
+// return to the start of a closed path and the cost of the tool changes
+struct PathOptReport {
+    std::vector<int> order;
+    double initialLength = 0.0;     // input order
+    double greedyLength = 0.0;      // greedy or curve construction
+    double improvedLength = 0.0;    // after multi-start or the main stage
+    double length = 0.0;            // final
+    long initialToolChanges = 0;    // in the input order
+    long toolChanges = 0;           // final
+    MultiStartResult multi;         // multi-start runs only (order left empty)
+    PassReport main;                // 2-opt (moves) or LK (moves, kicks, seconds)
+    std::vector<PassReport> orOpt;  // Or-opt passes of a single-start run
+    bool timedOut = false;          // a stage stopped at the deadline
+};
+
+// Run the configured pipeline on pts.  The greedy order is always completed;
+// the later stages stop at the deadline, and with a limited deadline and no
+// explicit kick count iterated LK keeps kicking until it expires.
+PathOptReport optimizeOrder(const PointSet& pts, const PathOptOptions& opt,
+                            const Deadline& deadline = Deadline());
+
+// Paths of several machines (probe heads) measuring one part at once,
+// balanced so that the longest one, in the configured metric, is as short
+// as possible (min-max multi-TSP).  Route first, cluster second: the
+// pipeline builds one path through every point, the path is cut into
+// 'machines' consecutive pieces with the smallest possible largest cost, and
+// each piece is optimized on its own as an open path, the pieces in
+// parallel on a ThreadPool of opt.multi.threads.  As optimization shortens
+// some pieces more than others, the path is then cut again with the moves of
+// each piece scaled by the factor it showed, for a few rounds, and the best
+// split is kept.
+struct PartitionReport {
+    std::vector<PathOptReport> machines;   // orders index pts, in chain order
+    double singleLength = 0.0;             // the one path first cut up
+    double longest = 0.0;                  // largest machine path length
+    int rounds = 0;                        // cuts tried
+    double seconds = 0.0;
+    bool timedOut = false;                 // a path or the rounds stopped at the deadline
+};
+
+// Every machine path starts at its own first point and has a free end;
+// opt.ends and the ordering constraints are not used (tools are).  The
+// time budget is shared between the single path and the rounds.  Needs
+// 1 <= machines <= pts.size().
+PartitionReport optimizePartition(const PointSet& pts, int machines, const PathOptOptions& opt,
+                                  const Deadline& deadline = Deadline());
+
+#endif
@@ -0,0 +1,372 @@
+// ============================================================================
+// File: PathOptimizer.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Path length evaluation and greedy nearest-neighbor construction
+//   (see PathOptimizer.h).
+// ============================================================================
+
+#include "PathOptimizer.h"
+#include "KdTree.h"
+#include "DistanceKernels.h"
+#include "ThreadPool.h"   // for Barrier
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Compute total length of a path given point order
+//------------------------------------------------------------------------------
+template <class Metric>
+double computePathLength(const PointSet& pts, const vector<int>& order, const Metric& metric, bool closed) {
+    double total = 0.0;
+    for (size_t i = 1; i < order.size(); ++i) total += moveCost(metric, pts, order[i - 1], order[i]);
+    if (closed && order.size() > 1) total += moveCost(metric, pts, order.back(), order[0]);
+    return total;
+}
+
+//------------------------------------------------------------------------------
+// Greedy nearest-neighbor path optimization
+//
+// Starts from ends.start and repeatedly moves to the closest unvisited
+// point; a fixed end point is not offered and is visited last.
+//------------------------------------------------------------------------------
+
+// Reference implementation: full scan of the unvisited points at each step.
+// The unvisited set is a swap-remove array carrying packed copies of the
+// coordinates, so taking a point out is O(1) instead of shifting the tail as
+// vector::erase did, and the scan streams through contiguous memory.
+// Candidates are compared on the metric key, which keeps sqrt out of the
+// scan; for the Euclidean metrics the scan runs on the SIMD kernels of
+// DistanceKernels.h (with Z packed as zero for the 2D metric).
+namespace {
+
+struct Unvisited {
+    vector<int> id;
+    AlignedVector rx, ry, rz;
+    size_t m = 0;
+
+    Unvisited(const PointSet& pts, bool usesZ, const PathEnds& ends) {
+        int n = static_cast<int>(pts.size());
+        id.reserve(n);
+        for (int i = 0; i < n; ++i)
+            if (i != ends.start && i != ends.end) id.push_back(i);
+        m = id.size();
+        rx.resize(m);
+        ry.resize(m);
+        rz.resize(m);
+        for (size_t k = 0; k < m; ++k) {
+            rx[k] = pts.x[id[k]];
+            ry[k] = pts.y[id[k]];
+            rz[k] = usesZ ? pts.z[id[k]] : 0.0;
+        }
+    }
+
+    void remove(size_t i) {
+        --m;
+        id[i] = id[m];
+        rx[i] = rx[m];
+        ry[i] = ry[m];
+        rz[i] = rz[m];
+    }
+};
+
+struct Candidate {
+    double key = numeric_limits<double>::max();
+    size_t idx = 0;
+    bool valid = false;
+};
+
+// Is c a better pick than the current best?  Candidates must be offered in
+// array order for the scan-order tie rule to hold.
+inline bool better(const Unvisited& u, const Candidate& c, const Candidate& best, bool lowestIndexTies) {
+    if (!best.valid) return true;
+    return c.key < best.key ||
+           (lowestIndexTies && c.key == best.key && u.id[c.idx] < u.id[best.idx]);
+}
+
+// Closest unvisited point among array slots [begin, end): found by the
+// widest SIMD kernel the CPU supports for the Euclidean metrics, by a scalar
+// loop with the same tie rule for the others (adding the point cost of the
+// candidate, the one of the current point being the same for all)
+template <class Metric>
+Candidate scanRange(const Metric& metric, const Unvisited& u, size_t begin, size_t end,
+                    double cx, double cy, double cz, bool lowestIndexTies) {
+    Candidate best;
+    if (begin >= end) return best;
+    best.valid = true;
+    if constexpr (Metric::squaredEuclidean) {
+        static const ArgminKernel kernel = argminKernel();
+        ArgminResult r = kernel(u.rx.data(), u.ry.data(), u.rz.data(),
+                                lowestIndexTies ? u.id.data() : nullptr, begin, end, cx, cy, cz);
+        best.key = r.dist2;
+        best.idx = r.idx;
+        return best;
+    }
+    auto keyOf = [&](size_t i) {
+        double key = metric.key(u.rx[i] - cx, u.ry[i] - cy, u.rz[i] - cz);
+        if constexpr (Metric::hasPointCost) key += metric.pointCost(u.rz[i]);
+        return key;
+    };
+    best.key = keyOf(begin);
+    best.idx = begin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        double key = keyOf(i);
+        if (key < best.key || (lowestIndexTies && key == best.key && u.id[i] < u.id[best.idx])) {
+            best.key = key;
+            best.idx = i;
+        }
+    }
+    return best;
+}
+
+// Below this many unvisited points per thread the barrier costs more than the
+// scan it splits, so the walk finishes on the calling thread.
+const size_t kMinChunk = 4096;
+
+} // namespace
+
+template <class Metric>
+vector<int> optimizePathBruteForce(const PointSet& pts, bool lowestIndexTies, int threads,
+                                   const PathEnds& ends, const Metric& metric) {
+    size_t n = pts.size();
+    vector<int> order;
+    order.reserve(n);
+    if (n == 0) return order;
+
+    Unvisited u(pts, Metric::usesZ, ends);
+
+    int current = ends.start;
+    double cx = pts.x[current], cy = pts.y[current], cz = Metric::usesZ ? pts.z[current] : 0.0;
+    order.push_back(current);
+
+    auto step = [&](size_t bestIdx) {
+        current = u.id[bestIdx];
+        cx = u.rx[bestIdx];
+        cy = u.ry[bestIdx];
+        cz = u.rz[bestIdx];
+        order.push_back(current);
+        u.remove(bestIdx);
+    };
+
+    if (threads <= 0) threads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    size_t nThreads = min(static_cast<size_t>(threads), max<size_t>(1, u.m / kMinChunk));
+
+    if (nThreads > 1) {
+        // Persistent workers scan one contiguous chunk each per step and meet
+        // the calling thread (chunk 0) at two barriers: 'go' publishes the
+        // current point and array size, 'done' publishes the chunk minima.
+        // The chunk minima are merged in chunk order with the same rule as
+        // the serial scan, so the walk is identical for any thread count.
+        struct alignas(64) Slot { Candidate best; };
+        vector<Slot> slots(nThreads);
+        Barrier go(static_cast<int>(nThreads)), done(static_cast<int>(nThreads));
+        bool stop = false;
+
+        auto scanChunk = [&](size_t t) {
+            size_t begin = u.m * t / nThreads;
+            size_t end = u.m * (t + 1) / nThreads;
+            slots[t].best = scanRange(metric, u, begin, end, cx, cy, cz, lowestIndexTies);
+        };
+
+        vector<thread> workers;
+        for (size_t t = 1; t < nThreads; ++t) {
+            workers.emplace_back([&, t] {
+                for (;;) {
+                    go.arriveAndWait();
+                    if (stop) return;
+                    scanChunk(t);
+                    done.arriveAndWait();
+                }
+            });
+        }
+
+        while (u.m >= nThreads * kMinChunk) {
+            go.arriveAndWait();
+            scanChunk(0);
+            done.arriveAndWait();
+
+            Candidate best;
+            for (size_t t = 0; t < nThreads; ++t)
+                if (slots[t].best.valid && better(u, slots[t].best, best, lowestIndexTies))
+                    best = slots[t].best;
+            step(best.idx);
+        }
+
+        stop = true;
+        go.arriveAndWait();
+        for (auto& w : workers) w.join();
+    }
+
+    while (u.m > 0)
+        step(scanRange(metric, u, 0, u.m, cx, cy, cz, lowestIndexTies).idx);
+    if (ends.end >= 0) order.push_back(ends.end);
+
+    return order;
+}
+
+// Constrained walk.  The trees start empty and only hold the points that
+// may come next: the unvisited points of the current group whose
+// predecessors have all been visited.  Groups are opened in order; points
+// still blocked when their group runs dry (only possible with a precedence
+// cycle) are released all at once.  With tools there is one tree per tool,
+// and the walk moves to another tool only when that is cheaper, change
+// included, than the nearest point left for the current one.  firstMove >= 0
+// picks the first move among the released points instead (multi-start).
+template <class Metric>
+static vector<int> constrainedWalk(const PointSet& pts, const PathEnds& ends, const PathConstraints& cons,
+                                   const Metric& metric, long firstMove) {
+    int n = static_cast<int>(pts.size());
+    int groups = cons.groupCount();
+    vector<int> order;
+    order.reserve(n);
+
+    // Points of each group, in index order
+    vector<int> first(groups + 1, 0), members(n);
+    for (int i = 0; i < n; ++i) ++first[cons.groupOf(i) + 1];
+    for (int g = 0; g < groups; ++g) first[g + 1] += first[g];
+    vector<int> slot(first.begin(), first.end() - 1);
+    for (int i = 0; i < n; ++i) members[slot[cons.groupOf(i)]++] = i;
+
+    // One tree per tool over copies of its points (local index -> point)
+    int tools = cons.hasTools() ? cons.toolCount() : 1;
+    auto toolOf = [&](int i) { return tools > 1 ? cons.toolOf(i) : 0; };
+    vector<vector<int>> toolPoints(tools);
+    vector<int> local(n);
+    for (int i = 0; i < n; ++i) {
+        local[i] = static_cast<int>(toolPoints[toolOf(i)].size());
+        toolPoints[toolOf(i)].push_back(i);
+    }
+    vector<KdTree<Metric>> trees;
+    trees.reserve(tools);
+    for (int t = 0; t < tools; ++t) {
+        trees.emplace_back(PointSet(pts, toolPoints[t]), metric);
+        for (size_t j = 0; j < toolPoints[t].size(); ++j) trees[t].remove(static_cast<int>(j));
+    }
+    int present = 0;
+    auto release = [&](int i) {
+        KdTree<Metric>& tree = trees[toolOf(i)];
+        present -= tree.size();
+        tree.insert(local[i]);
+        present += tree.size();
+    };
+
+    vector<int> waiting(n);
+    for (int i = 0; i < n; ++i) waiting[i] = cons.predCount(i);
+    vector<char> visited(n, 0);
+    int open = -1;   // group being walked
+
+    auto visit = [&](int v) {
+        order.push_back(v);
+        visited[v] = 1;
+        for (const int* w = cons.succBegin(v); w != cons.succEnd(v); ++w)
+            if (--waiting[*w] == 0 && cons.groupOf(*w) == open && !visited[*w] && *w != ends.end)
+                release(*w);
+    };
+
+    // Nearest point of the current tool, unless another tool is cheaper
+    int current = ends.start;
+    auto next = [&]() {
+        double x = pts.x[current], y = pts.y[current], z = pts.z[current];
+        int t = toolOf(current);
+        int best = -1;
+        double bestCost = numeric_limits<double>::max();
+        if (trees[t].size() > 0) {
+            best = toolPoints[t][trees[t].nearest(x, y, z)];
+            bestCost = moveCost(metric, pts, current, best);
+        }
+        if (tools > 1 && !(bestCost <= cons.toolChangeCost())) {
+            for (int u = 0; u < tools; ++u) {
+                if (u == t || trees[u].size() == 0) continue;
+                int i = toolPoints[u][trees[u].nearest(x, y, z)];
+                double c = moveCost(metric, pts, current, i) + cons.toolChangeCost();
+                if (c < bestCost) {
+                    best = i;
+                    bestCost = c;
+                }
+            }
+        }
+        return best;
+    };
+
+    visit(current);
+    for (open = 0; open < groups; ++open) {
+        for (bool all = false;; all = true) {
+            for (int k = first[open]; k < first[open + 1]; ++k) {
+                int i = members[k];
+                if (!visited[i] && i != ends.end && (all || waiting[i] <= 0)) release(i);
+            }
+            if (present == 0) break;
+            if (firstMove >= 0 && order.size() == 1) {
+                // Released points of the group, in index order, as above
+                vector<int> ready;
+                for (int k = first[open]; k < first[open + 1]; ++k) {
+                    int i = members[k];
+                    if (!visited[i] && i != ends.end && (all || waiting[i] <= 0)) ready.push_back(i);
+                }
+                current = ready[firstMove % static_cast<long>(ready.size())];
+                trees[toolOf(current)].remove(local[current]);
+                --present;
+                visit(current);
+            }
+            while (present > 0) {
+                current = next();
+                trees[toolOf(current)].remove(local[current]);
+                --present;
+                visit(current);
+            }
+        }
+    }
+    if (ends.end >= 0) order.push_back(ends.end);
+
+    return order;
+}
+
+// Same walk driven by a k-d tree with deletion: about O(n log n) overall
+template <class Metric>
+vector<int> optimizePathKdTree(const PointSet& pts, const PathEnds& ends, const PathConstraints& cons,
+                               const Metric& metric, long firstMove) {
+    size_t n = pts.size();
+    vector<int> order;
+    order.reserve(n);
+    if (n == 0) return order;
+    if (!cons.empty() || cons.hasTools()) return constrainedWalk(pts, ends, cons, metric, firstMove);
+
+    KdTree<Metric> tree(pts, metric);
+    int current = ends.start;
+    order.push_back(current);
+    tree.remove(current);
+    if (ends.end >= 0) tree.remove(ends.end);
+
+    while (tree.size() > 0) {
+        current = tree.nearest(pts.x[current], pts.y[current], pts.z[current]);
+        order.push_back(current);
+        tree.remove(current);
+    }
+    if (ends.end >= 0) order.push_back(ends.end);
+
+    return order;
+}
+
+template <class Metric>
+vector<int> optimizePath(const PointSet& pts, NNEngine engine, bool lowestIndexTies, int threads,
+                         const PathEnds& ends, const PathConstraints& cons, const Metric& metric) {
+    return engine == NNEngine::KdTree || !cons.empty() || cons.hasTools()
+               ? optimizePathKdTree(pts, ends, cons, metric)
+               : optimizePathBruteForce(pts, lowestIndexTies, threads, ends, metric);
+}
+
+#define INSTANTIATE(M)                                                                                     \
+    template double computePathLength<M>(const PointSet&, const vector<int>&, const M&, bool);             \
+    template vector<int> optimizePath<M>(const PointSet&, NNEngine, bool, int, const PathEnds&,            \
+                                         const PathConstraints&, const M&);                                \
+    template vector<int> optimizePathBruteForce<M>(const PointSet&, bool, int, const PathEnds&, const M&); \
+    template vector<int> optimizePathKdTree<M>(const PointSet&, const PathEnds&, const PathConstraints&,   \
+                                               const M&, long);
+PATHOPT_FOR_EACH_METRIC(INSTANTIATE)
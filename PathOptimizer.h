@@ -0,0 +1,77 @@
+// ============================================================================
+// File: PathOptimizer.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Path length evaluation and greedy nearest-neighbor construction used by
+//   OptimizePath.  Kept separate from main() so that benchmarks and other
+//   front ends can link the optimizer directly.
+//
+//   Every function is a template on the distance metric (Metric.h),
+//   instantiated for each policy in PathOptimizer.cpp; the default is the
+//   3D Euclidean distance.
+// ============================================================================
+
+#ifndef PATHOPTIMIZER_H
+#define PATHOPTIMIZER_H
+
+#include <vector>
+
+#include "PointSet.h"
+#include "Metric.h"
+#include "PathEnds.h"
+#include "PathConstraints.h"
+
+// Nearest-neighbor search used by the greedy construction
+enum class NNEngine { KdTree, BruteForce };
+
+// Total length of the open path visiting pts in the given order, plus the
+// move back to order[0] if it is closed
+template <class Metric = Euclidean3D>
+double computePathLength(const PointSet& pts, const std::vector<int>& order,
+                         const Metric& metric = Metric(), bool closed = false);
+
+// Greedy nearest-neighbor path from ends.start (point 0 by default); a fixed
+// ends.end is kept out of the walk and appended last.  With constraints
+// (PathConstraints.h) each step goes to the closest point allowed next, and
+// the walk always runs on the k-d tree; ends.start must be able to come first
+// and ends.end last.  With tools it also does, and a step only changes tool
+// when the saving in travel outweighs the change.
+//
+// Both engines compare metric keys (squared distances for the Euclidean
+// metrics).  With lowestIndexTies (the default) equal keys go to the lowest
+// point index, which makes both engines agree and reproduces the original
+// erase-based scan (up to pairs of distinct squared distances whose square
+// roots round to the same double).  Without it the brute-force engine keeps
+// the first candidate met in its unvisited array; the result is still
+// deterministic but depends on the removal history.  The k-d tree engine
+// always uses lowest-index ties.
+//
+// 'threads' only affects the brute-force engine, whose scan of each step is
+// split across that many threads (<= 0: one per hardware core).  The order
+// returned is the same for every thread count.
+template <class Metric = Euclidean3D>
+std::vector<int> optimizePath(const PointSet& pts,
+                              NNEngine engine = NNEngine::KdTree,
+                              bool lowestIndexTies = true,
+                              int threads = 1,
+                              const PathEnds& ends = PathEnds(),
+                              const PathConstraints& cons = PathConstraints(),
+                              const Metric& metric = Metric());
+
+template <class Metric = Euclidean3D>
+std::vector<int> optimizePathBruteForce(const PointSet& pts, bool lowestIndexTies = true,
+                                        int threads = 1, const PathEnds& ends = PathEnds(),
+                                        const Metric& metric = Metric());
+
+// k-d tree greedy walk (multi-start passes its own start points).  With
+// visiting-order constraints the start cannot move, so firstMove >= 0 varies
+// the walk instead: its first move goes to point firstMove % m of the m
+// points allowed next (in index order) rather than to the nearest one.
+template <class Metric = Euclidean3D>
+std::vector<int> optimizePathKdTree(const PointSet& pts, const PathEnds& ends = PathEnds(),
+                                    const PathConstraints& cons = PathConstraints(),
+                                    const Metric& metric = Metric(), long firstMove = -1);
+
+#endif
@@ -0,0 +1,93 @@
+// ============================================================================
+// File: PathViewer.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   ROOT display of the original and optimized paths (see PathViewer.h).
+//   The only code linked against ROOT.
+// ============================================================================
+
+#include "PathViewer.h"
+
+#include "TApplication.h"
+#include "TCanvas.h"
+#include "TGraph.h"
+#include "TLegend.h"
+#include "TStyle.h"
+
+//------------------------------------------------------------------------------
+// Visualization: three separate canvases for original, optimized, and comparison
+//------------------------------------------------------------------------------
+extern "C" int showPaths(int* argc, char** argv, const double* x, const double* y,
+                         const int* origOrder, std::size_t nOrig,
+                         const int* optOrder, std::size_t nOpt) {
+    // Initialize ROOT GUI
+    TApplication app("OptimizePathApp", argc, argv);
+
+    gStyle->SetOptStat(0);
+
+    // --- 1. Original path ---
+    TCanvas* c1 = new TCanvas("c1", "Original Path", 800, 600);
+    (void)c1;
+    TGraph* gOrig = new TGraph(nOrig);
+    for (std::size_t i = 0; i < nOrig; ++i)
+        gOrig->SetPoint(i, x[origOrder[i]], y[origOrder[i]]);
+    gOrig->SetLineColor(kRed);
+    gOrig->SetLineWidth(2);
+    gOrig->SetMarkerStyle(20);
+    gOrig->SetTitle("Original Path;X;Y");
+    gOrig->Draw("ALP");
+
+    TLegend* leg1 = new TLegend(0.75, 0.82, 0.92, 0.9);
+    leg1->AddEntry(gOrig, "Original Path", "lp");
+    leg1->Draw();
+
+    // --- 2. Optimized path ---
+    TCanvas* c2 = new TCanvas("c2", "Optimized Path", 800, 600);
+    (void)c2;
+    TGraph* gOpt = new TGraph(nOpt);
+    for (std::size_t i = 0; i < nOpt; ++i)
+        gOpt->SetPoint(i, x[optOrder[i]], y[optOrder[i]]);
+    gOpt->SetLineColor(kBlue);
+    gOpt->SetLineWidth(2);
+    gOpt->SetMarkerStyle(21);
+    gOpt->SetTitle("Optimized Path;X;Y");
+    gOpt->Draw("ALP");
+
+    TLegend* leg2 = new TLegend(0.75, 0.82, 0.92, 0.9);
+    leg2->AddEntry(gOpt, "Optimized Path", "lp");
+    leg2->Draw();
+
+    // --- 3. Comparison: both paths superimposed ---
+    TCanvas* c3 = new TCanvas("c3", "Comparison: Original vs Optimized", 900, 700);
+    (void)c3;
+    TGraph* gOrig2 = new TGraph(*gOrig); // copy
+    TGraph* gOpt2  = new TGraph(*gOpt);
+
+    gOrig2->SetLineColor(kRed);
+    gOrig2->SetLineWidth(2);
+    gOrig2->SetMarkerStyle(20);
+    gOrig2->SetTitle("Original (Red) vs Optimized (Blue);X;Y");
+
+    gOpt2->SetLineColor(kBlue);
+    gOpt2->SetLineWidth(2);
+    gOpt2->SetMarkerStyle(21);
+
+    gOrig2->Draw("ALP");
+    gOpt2->Draw("LP SAME");
+
+    TLegend* leg3 = new TLegend(0.7, 0.8, 0.9, 0.9);
+    leg3->AddEntry(gOrig2, "Original Path", "lp");
+    leg3->AddEntry(gOpt2, "Optimized Path", "lp");
+    leg3->Draw();
+
+    // --- Update and run interactive session ---
+    c1->Update();
+    c2->Update();
+    c3->Update();
+
+    app.Run();  // Keeps all canvases open
+
+    return 0;
+}
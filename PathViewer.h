@@ -0,0 +1,37 @@
+// ============================================================================
+// File: PathViewer.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Interface of the ROOT viewer (PathViewer.cpp).  All ROOT code lives
+//   there.  It is built both into the libPathViewer plugin, which
+//   OptimizePath loads with dlopen() only when the canvases are actually
+//   shown (never in --batch mode), and into the standalone ViewPath program.
+// ============================================================================
+
+#ifndef PATHVIEWER_H
+#define PATHVIEWER_H
+
+#include <cstddef>
+
+#ifdef __APPLE__
+#define PATHVIEWER_LIBRARY "libPathViewer.dylib"
+#else
+#define PATHVIEWER_LIBRARY "libPathViewer.so"
+#endif
+
+#define PATHVIEWER_SYMBOL "showPaths"
+
+// Draw the original and optimized paths in the XY plane on three canvases
+// (original, optimized, both superimposed) and run the ROOT event loop until
+// the application is closed.  x and y are indexed by point; the orders
+// hold nOrig and nOpt point indices.
+extern "C" int showPaths(int* argc, char** argv, const double* x, const double* y,
+                         const int* origOrder, std::size_t nOrig,
+                         const int* optOrder, std::size_t nOpt);
+
+using ShowPathsFn = int (*)(int*, char**, const double*, const double*,
+                            const int*, std::size_t, const int*, std::size_t);
+
+#endif
@@ -0,0 +1,78 @@
+// ============================================================================
+// File: PointSet.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Structure-of-arrays copy of the point coordinates used by every hot loop
+//   of the optimizer.  Point (from ../common) keeps its label string and a
+//   heap-allocated coords vector next to each other, so scanning an array of
+//   Points drags label bytes and pointer chases through the cache.  PointSet
+//   is built once after readPoints() and holds x[], y[] and z[] as separate
+//   64-byte aligned arrays; the labels stay in the Point vector and are only
+//   read again when the output file is written.
+// ============================================================================
+
+#ifndef POINTSET_H
+#define POINTSET_H
+
+#include <cmath>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Points.h"  // from ../common
+
+// Minimal allocator returning cache-line aligned storage
+template <class T, std::size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(Align)); }
+
+    template <class U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <class U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+struct PointSet {
+    AlignedVector x, y, z;
+
+    PointSet() = default;
+
+    explicit PointSet(const std::vector<Point>& pts) : x(pts.size()), y(pts.size()), z(pts.size()) {
+        for (std::size_t i = 0; i < pts.size(); ++i) {
+            x[i] = pts[i].coords[0];
+            y[i] = pts[i].coords[1];
+            z[i] = pts[i].coords[2];
+        }
+    }
+
+    // Copy of the points idx[0], idx[1], ... of pts
+    PointSet(const PointSet& pts, const std::vector<int>& idx) : x(idx.size()), y(idx.size()), z(idx.size()) {
+        for (std::size_t i = 0; i < idx.size(); ++i) {
+            x[i] = pts.x[idx[i]];
+            y[i] = pts.y[idx[i]];
+            z[i] = pts.z[idx[i]];
+        }
+    }
+
+    std::size_t size() const { return x.size(); }
+
+    double distance(int a, int b) const {
+        double dx = x[b] - x[a];
+        double dy = y[b] - y[a];
+        double dz = z[b] - z[a];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+};
+
+#endif
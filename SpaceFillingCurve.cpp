@@ -0,0 +1,172 @@
+// ============================================================================
+// File: SpaceFillingCurve.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Hilbert and Morton curve keys and the curve construction (see
+//   SpaceFillingCurve.h).
+// ============================================================================
+
+#include "SpaceFillingCurve.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+// Bit interleaving: bit j of x goes to bit 3j (1by2) or 2j (1by1)
+//------------------------------------------------------------------------------
+static inline uint64_t spread1by2(uint64_t x) {
+    x &= 0x1fffff;   // 21 bits
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+    x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2)  & 0x1249249249249249ULL;
+    return x;
+}
+
+static inline uint64_t spread1by1(uint64_t x) {
+    x &= 0xffffffffULL;
+    x = (x | x << 16) & 0x0000ffff0000ffffULL;
+    x = (x | x << 8)  & 0x00ff00ff00ff00ffULL;
+    x = (x | x << 4)  & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | x << 2)  & 0x3333333333333333ULL;
+    x = (x | x << 1)  & 0x5555555555555555ULL;
+    return x;
+}
+
+// Morton key of the cell (c[0], c[1], c[2]), c[0] being the most
+// significant bit of every group
+static inline uint64_t mortonKey(const uint32_t* c, int dims) {
+    if (dims == 3) return spread1by2(c[0]) << 2 | spread1by2(c[1]) << 1 | spread1by2(c[2]);
+    return spread1by1(c[0]) << 1 | spread1by1(c[1]);
+}
+
+// Hilbert key: Skilling's transform ("Programming the Hilbert curve", 2004)
+// turns the cell coordinates into the transposed Hilbert index, whose bits
+// interleave like a Morton key.  The bit tests are turned into masks (the
+// bits are random from point to point and the branches mispredict), and
+// the dimension is a template parameter so the coordinates stay in
+// registers.
+template <int Dims>
+static inline uint64_t hilbertKey(uint32_t* c, int bits) {
+    uint32_t x[Dims];
+    for (int i = 0; i < Dims; ++i) x[i] = c[i];
+    uint32_t top = 1u << (bits - 1);
+    for (uint32_t q = top; q > 1; q >>= 1) {   // inverse undo
+        uint32_t p = q - 1;
+        for (int i = 0; i < Dims; ++i) {
+            uint32_t set = 0u - ((x[i] & q) != 0);   // all ones if the bit is set
+            uint32_t t = (x[0] ^ x[i]) & p & ~set;   // swap low bits if not
+            x[0] ^= (p & set) | t;                   // invert low bits if set
+            x[i] ^= t;
+        }
+    }
+    for (int i = 1; i < Dims; ++i) x[i] ^= x[i - 1];   // Gray encode
+    uint32_t t = 0;
+    for (uint32_t q = top; q > 1; q >>= 1) t ^= (q - 1) & (0u - ((x[Dims - 1] & q) != 0));
+    for (int i = 0; i < Dims; ++i) c[i] = x[i] ^ t;
+    return mortonKey(c, Dims);
+}
+
+//------------------------------------------------------------------------------
+// Keys
+//------------------------------------------------------------------------------
+vector<uint64_t> curveKeys(const PointSet& pts, Curve curve, bool useZ) {
+    size_t n = pts.size();
+    vector<uint64_t> keys(n, 0);
+    if (n == 0 || curve == Curve::None) return keys;
+
+    // One scale for all axes, so the cells are cubes
+    int dims = useZ ? 3 : 2;
+    int bits = useZ ? 21 : 32;
+    const AlignedVector* axis[3] = {&pts.x, &pts.y, &pts.z};
+    double lo[3], extent = 0.0;
+    for (int d = 0; d < dims; ++d) {
+        auto mm = minmax_element(axis[d]->begin(), axis[d]->end());
+        lo[d] = *mm.first;
+        extent = max(extent, *mm.second - *mm.first);
+    }
+    double cells = static_cast<double>((uint64_t(1) << bits) - 1);
+    double scale = extent > 0.0 ? cells / extent : 0.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t c[3];
+        for (int d = 0; d < dims; ++d)
+            c[d] = static_cast<uint32_t>(min(cells, ((*axis[d])[i] - lo[d]) * scale));
+        if (curve == Curve::Morton)
+            keys[i] = mortonKey(c, dims);
+        else
+            keys[i] = dims == 3 ? hilbertKey<3>(c, bits) : hilbertKey<2>(c, bits);
+    }
+    return keys;
+}
+
+//------------------------------------------------------------------------------
+// LSD radix sort of the point indices by key, 11 bits per pass (6 passes,
+// with 2048 counters that stay in L1).  The counts of all passes come from
+// one read of the keys, and passes whose digit is the same for every key
+// are skipped.  Stable, so equal keys keep index order.
+//------------------------------------------------------------------------------
+static const int kDigitBits = 11;
+static const int kPasses = (64 + kDigitBits - 1) / kDigitBits;
+static const uint64_t kDigitMask = (uint64_t(1) << kDigitBits) - 1;
+
+static vector<int> radixSortByKey(const vector<uint64_t>& keys) {
+    size_t n = keys.size();
+    struct Item {
+        uint64_t key;
+        int idx;
+    };
+    vector<Item> a(n), b(n);
+    vector<size_t> count(size_t(kPasses) << kDigitBits, 0);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = {keys[i], static_cast<int>(i)};
+        for (int pass = 0; pass < kPasses; ++pass)
+            ++count[(size_t(pass) << kDigitBits) + ((keys[i] >> (kDigitBits * pass)) & kDigitMask)];
+    }
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        size_t* c = count.data() + (size_t(pass) << kDigitBits);
+        int shift = kDigitBits * pass;
+        if (c[(a[0].key >> shift) & kDigitMask] == n) continue;   // one digit value only
+        size_t sum = 0;
+        for (size_t d = 0; d <= kDigitMask; ++d) {
+            size_t k = c[d];
+            c[d] = sum;
+            sum += k;
+        }
+        for (const Item& it : a) b[c[(it.key >> shift) & kDigitMask]++] = it;
+        a.swap(b);
+    }
+
+    vector<int> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = a[i].idx;
+    return order;
+}
+
+//------------------------------------------------------------------------------
+// Curve path
+//------------------------------------------------------------------------------
+vector<int> curvePath(const PointSet& pts, Curve curve, const PathEnds& ends, bool useZ) {
+    vector<int> order;
+    if (pts.size() == 0) return order;
+    vector<int> sorted = radixSortByKey(curveKeys(pts, curve, useZ));
+
+    auto dist2 = [&](int a, int b) {
+        double dx = pts.x[b] - pts.x[a], dy = pts.y[b] - pts.y[a];
+        double dz = useZ ? pts.z[b] - pts.z[a] : 0.0;
+        return dx * dx + dy * dy + dz * dz;
+    };
+    int s = ends.start;
+    if (dist2(s, sorted.back()) < dist2(s, sorted.front())) reverse(sorted.begin(), sorted.end());
+
+    order.reserve(pts.size());
+    order.push_back(s);
+    for (int i : sorted)
+        if (i != s && i != ends.end) order.push_back(i);
+    if (ends.end >= 0) order.push_back(ends.end);
+    return order;
+}
@@ -0,0 +1,100 @@
+// ============================================================================
+// File: ThreadPool.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Work-stealing thread pool (see ThreadPool.h).
+// ============================================================================
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int nThreads) {
+    if (nThreads <= 0) nThreads = max(1u, thread::hardware_concurrency());
+    for (int i = 0; i < nThreads; ++i) queues.emplace_back(new Queue);
+    for (int i = 0; i < nThreads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lk(m);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    unsigned q;
+    {
+        lock_guard<mutex> lk(m);
+        ++unfinished;
+        q = nextQueue++ % queues.size();
+    }
+    {
+        lock_guard<mutex> lk(queues[q]->m);
+        queues[q]->tasks.push_back(move(task));
+    }
+    {
+        // Publish under the pool mutex so a worker about to sleep sees it
+        lock_guard<mutex> lk(m);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lk(m);
+    done.wait(lk, [&] { return unfinished == 0; });
+    if (error) {
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+// Own deque from the back, then the other deques from the front
+bool ThreadPool::tryPop(int id, function<void()>& task) {
+    int n = static_cast<int>(queues.size());
+    for (int k = 0; k < n; ++k) {
+        Queue& q = *queues[(id + k) % n];
+        lock_guard<mutex> lk(q.m);
+        if (q.tasks.empty()) continue;
+        if (k == 0) {
+            task = move(q.tasks.back());
+            q.tasks.pop_back();
+        } else {
+            task = move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        --queued;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int id) {
+    for (;;) {
+        function<void()> task;
+        if (tryPop(id, task)) {
+            exception_ptr e;
+            try {
+                task();
+            } catch (...) {
+                e = current_exception();
+            }
+            lock_guard<mutex> lk(m);
+            if (e && !error) error = e;
+            if (--unfinished == 0) done.notify_all();
+            continue;
+        }
+
+        unique_lock<mutex> lk(m);
+        wake.wait(lk, [&] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
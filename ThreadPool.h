@@ -0,0 +1,96 @@
+// ============================================================================
+// File: ThreadPool.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Small work-stealing thread pool.  Every worker owns a task deque: it
+//   takes work from the back of its own deque and, when that is empty,
+//   steals from the front of the others.  Tasks are dealt round-robin at
+//   submission, so uneven task costs even out through stealing.
+//
+//   A Barrier for lock-step groups of persistent threads is provided too.
+//
+//   The pool makes no promise about which thread runs a task or in what
+//   order; callers that need reproducible results write each task's output
+//   to its own slot and combine the slots afterwards.
+// ============================================================================
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // nThreads <= 0 uses one thread per hardware core
+    explicit ThreadPool(int nThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished.  Rethrows the first
+    // exception raised by a task, if any.
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(int id);
+    bool tryPop(int id, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex m;                       // guards the sleep/wake and completion state below
+    std::condition_variable wake, done;
+    std::atomic<long> queued{0};        // tasks sitting in a deque
+    long unfinished = 0;                // tasks submitted but not yet finished
+    bool stopping = false;
+    unsigned nextQueue = 0;
+    std::exception_ptr error;
+};
+
+// Reusable barrier for a fixed group of threads that meet once per step.
+// Waiters spin briefly and then yield, which keeps the per-step cost low on
+// a many-core machine without starving an oversubscribed one.
+class Barrier {
+public:
+    explicit Barrier(int nThreads) : count(nThreads) {}
+
+    void arriveAndWait() {
+        unsigned gen = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (int spin = 0; generation.load(std::memory_order_acquire) == gen; ++spin)
+            if (spin >= kSpins) std::this_thread::yield();
+    }
+
+private:
+    static constexpr int kSpins = 2000;
+
+    const int count;
+    std::atomic<int> waiting{0};
+    std::atomic<unsigned> generation{0};
+};
+
+#endif
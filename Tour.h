@@ -0,0 +1,125 @@
+// ============================================================================
+// File: Tour.h
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Array-based tour used by the local-search optimizers.
+//
+//   An open path p0 -> p1 -> ... -> p(n-1) is stored as a cycle through one
+//   extra "depot" node (index n) whose edges cost nothing:
+//
+//       depot -> p0 -> p1 -> ... -> p(n-1) -> depot
+//
+//   The edge depot-p0 is fixed, which pins the start of the path, while the
+//   edge p(n-1)-depot may be exchanged like any other, which leaves the end
+//   free; with a fixed end it is pinned too.  A closed path uses the same
+//   layout, the depot standing for the start point again (EdgeCost in
+//   LocalSearch.h charges the return move on its edges).  Every move can
+//   then be written as cycle segment reversals, and a reversal always flips
+//   the shorter of the two arcs, so its cost is at most n/2 swaps.
+// ============================================================================
+
+#ifndef TOUR_H
+#define TOUR_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+class Tour {
+public:
+    // Open path visiting the points in 'order', starting at order[0] and,
+    // with fixedEnd, always ending at order.back()
+    explicit Tour(const std::vector<int>& order, bool fixedEnd = false)
+        : nPoints(static_cast<int>(order.size())),
+          nodes(order.size() + 1),
+          posOf(order.size() + 1) {
+        nodes[0] = nPoints;   // depot
+        for (size_t i = 0; i < order.size(); ++i) nodes[i + 1] = order[i];
+        for (int i = 0; i < size(); ++i) posOf[nodes[i]] = i;
+        start = nPoints > 0 ? order[0] : -1;
+        end = nPoints > 0 && fixedEnd ? order.back() : -1;
+    }
+
+    int size() const { return static_cast<int>(nodes.size()); }
+    int depot() const { return nPoints; }
+    bool isDepot(int a) const { return a == nPoints; }
+
+    int next(int a) const { int p = posOf[a] + 1; return nodes[p == size() ? 0 : p]; }
+    int prev(int a) const { int p = posOf[a]; return nodes[p == 0 ? size() - 1 : p - 1]; }
+    int pos(int a) const { return posOf[a]; }
+
+    // True if b lies on the forward walk from a to c (inclusive)
+    bool between(int a, int b, int c) const {
+        int pa = posOf[a], pb = posOf[b], pc = posOf[c];
+        if (pa <= pc) return pa <= pb && pb <= pc;
+        return pb >= pa || pb <= pc;
+    }
+
+    // Edges that no move may remove
+    bool isFixed(int a, int b) const {
+        if (b == nPoints) std::swap(a, b);
+        return a == nPoints && (b == start || b == end);
+    }
+
+    // Reverse the forward segment a..b (inclusive).  As a cycle this is the
+    // same as reversing the complementary arc, so the shorter one is flipped.
+    void reverse(int a, int b) {
+        int n = size();
+        int i = posOf[a], j = posOf[b];
+        int len = j - i;
+        if (len < 0) len += n;
+        len += 1;
+        if (2 * len > n) {
+            i = posOf[b] + 1; if (i == n) i = 0;
+            j = posOf[a] - 1; if (j < 0) j = n - 1;
+            len = n - len;
+        }
+        for (int k = 0; k < len / 2; ++k) {
+            std::swap(nodes[i], nodes[j]);
+            posOf[nodes[i]] = i;
+            posOf[nodes[j]] = j;
+            if (++i == n) i = 0;
+            if (--j < 0) j = n - 1;
+        }
+    }
+
+    // 2-opt move: replace edges (a,b) and (c,d) by (a,c) and (b,d).  The two
+    // edges must be given in the same direction of travel, i.e. either
+    // b == next(a) and d == next(c), or b == prev(a) and d == prev(c).
+    void move2opt(int a, int b, int c, int d) {
+        if (next(a) == b) reverse(b, c);
+        else              reverse(a, d);
+    }
+
+    // Number of nodes move2opt(a, b, c, d) would have to swap around
+    int moveCost(int a, int b, int c, int d) const {
+        int i, j;
+        if (next(a) == b) { i = posOf[b]; j = posOf[c]; }
+        else              { i = posOf[a]; j = posOf[d]; }
+        int len = j - i;
+        if (len < 0) len += size();
+        len += 1;
+        return std::min(len, size() - len);
+    }
+
+    // The open path, read from the start point away from the depot
+    std::vector<int> path() const {
+        std::vector<int> out;
+        out.reserve(nPoints);
+        if (nPoints == 0) return out;
+        bool forward = next(nPoints) == start;
+        for (int a = start; a != nPoints; a = forward ? next(a) : prev(a)) out.push_back(a);
+        return out;
+    }
+
+private:
+    int nPoints;
+    int start;
+    int end;                  // -1 if free
+    std::vector<int> nodes;   // position -> node
+    std::vector<int> posOf;   // node -> position
+};
+
+#endif
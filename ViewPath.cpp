@@ -0,0 +1,63 @@
+// ============================================================================
+// File: ViewPath.cpp
+// Author: Luciano Ristori
+// Created: October 2025
+//
+// Description:
+//   Standalone ROOT viewer for an optimization that has already been run,
+//   e.g. in --batch mode: shows the points of the input file in their
+//   original order and those of the output file in optimized order, on the
+//   same three canvases as OptimizePath.  Either file may be CSV or a binary
+//   point file.
+//
+// Usage:
+//   ./ViewPath input.csv output.csv
+//
+// Build:
+//   make viewer
+// ============================================================================
+
+#include <iostream>
+#include <numeric>   // for std::iota
+#include <string>
+#include <vector>
+
+#include "PathIO.h"
+#include "PathViewer.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " input.csv output.csv" << endl;
+        return 1;
+    }
+
+    PointCloud orig, opt;
+    string error;
+    for (int f = 1; f <= 2; ++f) {
+        PointCloud& cloud = f == 1 ? orig : opt;
+        if (!loadPoints(argv[f], cloud, error)) {
+            cerr << "Error: " << error << endl;
+            return 1;
+        }
+        if (cloud.size() == 0) {
+            cerr << "Error: no points read from " << argv[f] << endl;
+            return 1;
+        }
+    }
+
+    // Both point lists side by side: the original order indexes the first
+    // block, the optimized order the second
+    size_t n = orig.size(), m = opt.size();
+    vector<double> x, y;
+    for (const PointCloud* cloud : {&orig, &opt}) {
+        x.insert(x.end(), cloud->coords.x.begin(), cloud->coords.x.end());
+        y.insert(y.end(), cloud->coords.y.begin(), cloud->coords.y.end());
+    }
+    vector<int> origOrder(n), optOrder(m);
+    iota(origOrder.begin(), origOrder.end(), 0);
+    iota(optOrder.begin(), optOrder.end(), static_cast<int>(n));
+
+    return showPaths(&argc, argv, x.data(), y.data(), origOrder.data(), n, optOrder.data(), m);
+}